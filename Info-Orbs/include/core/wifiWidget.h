@@ -2,6 +2,11 @@
 #ifndef WIFIWIDGET_H
 #define WIFIWIDGET_H
 #include "widget.h"
+#include <histogram.h>
+
+#define WIFI_CONNECT_TIMEOUT 10000      // show the connection error after this long without a connection (ms)
+#define WIFI_FAST_CONNECT_TIMEOUT 4000  // give up on the cached channel and BSSID after this long (ms)
+#define WIFI_PREFERENCES "wifi"         // NVS namespace of the connection cache
 
 class WifiWidget : public Widget{
 public:
@@ -11,13 +16,34 @@ public:
     void update(bool force = false) override;
     void draw(bool force = false) override;
     void changeMode() override;
+    const char *getName() override { return "wifi"; }
 
     bool isConnected() { return m_isConnected; }
+    static void connect();
 
 private:
-
+    // Where the last successful connection went, kept in NVS
+    struct Cache {
+        uint32_t ssidHash;  // the cache belongs to this WIFI_SSID
+        uint8_t bssid[6];
+        uint8_t channel;
+        uint32_t ip;
+        uint32_t gateway;
+        uint32_t subnet;
+        uint32_t dns;
+    };
+
+    static bool loadCache(Cache &cache);
+    static uint32_t ssidHash();
+    void fallBackToScan();
+    void onConnected();
     void connectionTimedOut();
 
+    static bool m_fastPath;  // connecting with the cached settings
+    static unsigned long m_connectStart;
+    Histogram m_fastConnects;
+    Histogram m_scanConnects;
+
     bool m_isConnected{ false };
     bool m_connectionFailed{ false };
 
@@ -27,8 +53,6 @@ private:
     
     String m_connectionString{ "" };
     String m_dotsString{ "" };
-    int m_connectionTimer{ 0 };
-    const int m_connectionTimeout{ 10000 };
 
 };
 
@@ -2,32 +2,36 @@
 #define STOCK_DATA_MODEL_H
 
 #include <Arduino.h>
+#include <fixedString.h>
+#include <utils.h>
 
 #include <iomanip>
 
+#define STOCK_SYMBOL_LENGTH 12  // longest ticker symbol kept, exchange suffix included
+
 class StockDataModel {
    public:
     StockDataModel();
-    StockDataModel &setSymbol(String symbol);
-    String getSymbol();
+    StockDataModel &setSymbol(StringView symbol);
+    const FixedString<STOCK_SYMBOL_LENGTH> &getSymbol();
     StockDataModel &setCurrentPrice(float currentPrice);
     float getCurrentPrice();
-    String getCurrentPrice(int8_t digits);
+    FormattedFloat getCurrentPrice(int8_t digits);
     StockDataModel &setVolume(float volume);
     float getVolume();
-    String getVolume(int8_t digits);
+    FormattedFloat getVolume(int8_t digits);
     StockDataModel &setPriceChange(float change);
     float getPriceChange();
-    String getPriceChange(int8_t digits);
+    FormattedFloat getPriceChange(int8_t digits);
     StockDataModel &setPercentChange(float percentChange);
     float getPercentChange();
-    String getPercentChange(int8_t digits);
+    FormattedFloat getPercentChange(int8_t digits);
 
     bool isChanged();
     StockDataModel &setChangedStatus(bool changed);
 
    private:
-    String m_symbol = "";
+    FixedString<STOCK_SYMBOL_LENGTH> m_symbol;
     float m_currentPrice = 0.0;
     float m_volume = 0.0;
     float m_priceChange = 0.0;
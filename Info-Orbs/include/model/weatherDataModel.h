@@ -2,57 +2,65 @@
 #define WEAHTERDATA_MODEL_H
 
 #include <Arduino.h>
+#include <fixedString.h>
+#include <utils.h>
 #include <iomanip>
 
 #define NaN -1024.0
+#define WEATHER_CITY_LENGTH 64   // "resolvedAddress", only the part before the first comma is shown
+#define WEATHER_TEXT_LENGTH 160  // more than fits on the orb, the layout ellipsizes it
+#define WEATHER_ICON_LENGTH 24   // longest is "partly-cloudy-night"
+
+typedef FixedString<WEATHER_ICON_LENGTH> WeatherIconName;
+
 class WeatherDataModel {
    public:
     WeatherDataModel();
-    WeatherDataModel &setCityName(String city);
-    String getCityName();
-    WeatherDataModel &setCurrentText(String text);
-    String getCurrentText();
-    WeatherDataModel &setCurrentIcon(String icon);
-    String getCurrentIcon();
+    WeatherDataModel &setCityName(StringView city);
+    const FixedString<WEATHER_CITY_LENGTH> &getCityName();
+    WeatherDataModel &setCurrentText(StringView text);
+    const FixedString<WEATHER_TEXT_LENGTH> &getCurrentText();
+    WeatherDataModel &setCurrentIcon(StringView icon);
+    const WeatherIconName &getCurrentIcon();
     WeatherDataModel &setCurrentTemperature(float degrees);
     float getCurrentTemperature();
-    String getCurrentTemperature(int8_t digits);
+    FormattedFloat getCurrentTemperature(int8_t digits);
     WeatherDataModel &setTodayHigh(float high);
     float getTodayHigh();
-    String getTodayHigh(int8_t digits);
+    FormattedFloat getTodayHigh(int8_t digits);
     WeatherDataModel &setTodayLow(float low);
     float getTodayLow();
-    String getTodayLow(int8_t digits);
+    FormattedFloat getTodayLow(int8_t digits);
 
-    WeatherDataModel &setDaysIcons(String icons[3]);
-    String &getDaysIcons();
-    WeatherDataModel &setDayIcon(int num, String icon);
-    String getDayIcon(int num);
+    WeatherDataModel &setDaysIcons(StringView icons[3]);
+    const WeatherIconName &getDaysIcons();
+    WeatherDataModel &setDayIcon(int num, StringView icon);
+    const WeatherIconName &getDayIcon(int num);
 
     WeatherDataModel &setDaysHighs(float highs[3]);
     float &getDaysHighs();
     WeatherDataModel &setDayHigh(int num, float high);
     float getDayHigh(int num);
-    String getDayHigh(int8_t num, int8_t digits);
+    FormattedFloat getDayHigh(int8_t num, int8_t digits);
 
     WeatherDataModel &setDaysLows(float lows[3]);
     float &getDaysLows();
     WeatherDataModel &setDayLow(int num, float low);
     float getDayLow(int num);
-    String getDayLow(int8_t num, int8_t digits);
+    FormattedFloat getDayLow(int8_t num, int8_t digits);
 
     bool isChanged();
     WeatherDataModel &setChangedStatus(bool changed);
 
    private:
-    String m_cityName;
-    String m_currentWeatherText = "";  // Weather Description
-    String m_currentWeatherIcon = "";  // Text refrence for weather icon
+    FixedString<WEATHER_CITY_LENGTH> m_cityName;
+    FixedString<WEATHER_TEXT_LENGTH> m_currentWeatherText;  // Weather Description
+    WeatherIconName m_currentWeatherIcon;                   // Text refrence for weather icon
     float m_currentWeatherDeg = 0.0;
     float m_todayHigh = 0.0;
     float m_todayLow = 0.0;
 
-    String m_daysIcons[3] = { "", "", "" };
+    WeatherIconName m_daysIcons[3];
     float m_daysHigh[3] = { NaN, NaN, NaN };
     float m_daysLow[3] = { NaN, NaN, NaN };
 
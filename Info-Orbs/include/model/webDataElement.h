@@ -4,18 +4,55 @@
 #include <ArduinoJson.h>
 #include <TFT_eSPI.h>
 
-class WebDataElement {
-   public:
-    virtual ~WebDataElement() = default;
+#define WEB_DATA_NO_TEXT 0xFFFF  // text offset of elements without text
 
-    bool isChanged();
-    void setChangedStatus(bool changed);
+#define WEB_DATA_ELEMENT_CHANGED 0x01
+#define WEB_DATA_ELEMENT_FILLED 0x02
+#define WEB_DATA_ELEMENT_RAW 0x04  // image is raw RGB565 rather than JPEG
 
-    virtual void parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground);
+// The numeric values double as the compact "type" encoding on the wire, only append to this list
+enum WebDataElementModelTypes {
+    TEXT,
+    CHARACTER,
+    LINE,
+    RECTANGLE,
+    TRIANGLE,
+    CIRCLE,
+    ARC,
+    IMAGE,
+    OTHER
+};
+
+// Screen area an element covers, empty when it draws nothing
+struct WebDataBounds {
+    int16_t x = 0;
+    int16_t y = 0;
+    int16_t w = 0;
+    int16_t h = 0;
+
+    bool isEmpty() const;
+    bool intersects(const WebDataBounds& other) const;
+    static WebDataBounds fromPoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2);
+    static WebDataBounds fromText(int32_t x, int32_t y, int32_t w, int32_t h, int32_t datum);
+};
 
-    virtual void draw(TFT_eSPI& display);
+// One parsed element as a flat, fixed size record. Displays keep these in a
+// contiguous array and draw them with a switch on the type, see WebDataElementModel.
+struct WebDataElement {
+    uint32_t id = 0;       // hash of the element's "id", 0 when it has none
+    WebDataBounds drawn;   // where the last draw painted
+    int16_t x = 0;
+    int16_t y = 0;
+    int16_t v[4] = {0, 0, 0, 0};  // type specific, e.g. x2/y2/x3/y3, width/height or radius/innerRadius/angleStart/angleEnd
+    uint16_t color = TFT_WHITE;   // RGB565
+    uint16_t background = TFT_BLACK;
+    uint16_t text = WEB_DATA_NO_TEXT;  // offset into the display's text table
+    uint8_t type = OTHER;
+    uint8_t font = 2;
+    uint8_t size = 2;
+    uint8_t datum = MC_DATUM;
+    uint8_t flags = 0;
 
-   protected:
-    bool m_changed = false;
+    bool drawsSameAs(const WebDataElement& other) const;
 };
 #endif
@@ -7,22 +7,15 @@
 #include "utils.h"
 #include "webDataElement.h"
 
-class WebDataElementImageModel : public WebDataElement {
+// Parses and draws "image" elements from the image cache, their text is the "image" URL
+class WebDataElementImageModel {
    public:
-    int32_t getX();
-    void setX(int32_t x);
-    int32_t getY();
-    void setY(int32_t y);
-
-    void setImage(String image);
-    String getImage();
-
-    void parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground) override;
-    void draw(TFT_eSPI& display) override;
+    static const char* parseData(const JsonObject& doc, WebDataElement& element);
+    static void draw(const WebDataElement& element, const char* text, TFT_eSPI& display);
+    static WebDataBounds getBounds(const WebDataElement& element, const char* text, TFT_eSPI& display);
+    static void refresh(WebDataElement& element, const char* text);
 
    private:
-    int32_t m_x = 0;
-    int32_t m_y = 0;
-    String m_image = "";
+    static uint8_t getScale(const WebDataElement& element);
 };
 #endif
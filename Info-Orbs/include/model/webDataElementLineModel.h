@@ -7,30 +7,11 @@
 #include "utils.h"
 #include "webDataElement.h"
 
-class WebDataElementLineModel : public WebDataElement {
+// Parses and draws "line" elements
+class WebDataElementLineModel {
    public:
-    int32_t getX();
-    void setX(int32_t x);
-    int32_t getY();
-    void setY(int32_t y);
-
-    int32_t getX2();
-    void setX2(int32_t x);
-    int32_t getY2();
-    void setY2(int32_t y);
-
-    void setColor(int32_t color);
-    void setColor(String color);
-    int32_t getColor();
-
-    void parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground) override;
-    void draw(TFT_eSPI& display) override;
-
-   private:
-    int32_t m_x = 0;
-    int32_t m_y = 0;
-    int32_t m_x2 = 0;
-    int32_t m_y2 = 0;
-    int32_t m_color = -1;
+    static const char* parseData(const JsonObject& doc, WebDataElement& element);
+    static void draw(const WebDataElement& element, const char* text, TFT_eSPI& display);
+    static WebDataBounds getBounds(const WebDataElement& element, const char* text, TFT_eSPI& display);
 };
 #endif
@@ -7,33 +7,15 @@
 #include "utils.h"
 #include "webDataElement.h"
 
-enum WebDataElementModelTypes {
-    TEXT,
-    CHARACTER,
-    LINE,
-    RECTANGLE,
-    TRIANGLE,
-    CIRCLE,
-    ARC,
-    IMAGE,
-    OTHER
-};
-
+// Dispatches on WebDataElement::type to the per-type models, without virtual calls
 class WebDataElementModel {
    public:
-    void setType(const String& type);
-    WebDataElementModelTypes getType();
-
-    bool isChanged();
-    void setChangedStatus(bool changed);
-
-    void parseData(JsonObject doc, int32_t defaultColor, int32_t defaultBackground);
-    void draw(TFT_eSPI& display);
-
-   private:
-    WebDataElementModelTypes m_type = OTHER;
-    WebDataElement* m_element = nullptr;
+    static WebDataElementModelTypes parseType(JsonVariantConst type);
+    static WebDataElementModelTypes parseTypeName(const char* type);
+    static uint32_t parseId(JsonVariantConst id);
 
-    bool m_changed = false;
+    static const char* parseData(const JsonObject& doc, WebDataElement& element);
+    static void draw(const WebDataElement& element, const char* text, TFT_eSPI& display);
+    static WebDataBounds getBounds(const WebDataElement& element, const char* text, TFT_eSPI& display);
 };
 #endif
@@ -0,0 +1,45 @@
+#ifndef WEB_DATA_ELEMENT_POOL_H
+#define WEB_DATA_ELEMENT_POOL_H
+
+#include <config.h>
+
+#include "webDataElement.h"
+
+#ifndef WEB_DATA_POOL_SLOTS
+#define WEB_DATA_POOL_SLOTS 256  // element records shared by all displays of a widget, 36 bytes each
+#endif
+#define WEB_DATA_POOL_REPORT_INTERVAL 60000  // dropped elements are logged at most this often (ms)
+
+// Slot counters, readable so a soak run can check them rather than the log
+struct WebDataPoolStats {
+    uint16_t used;
+    uint16_t peak;
+    uint32_t acquired;
+    uint32_t released;
+    uint32_t exhausted;  // acquires that found every slot taken
+    uint32_t dropped;    // elements displays could not show for want of a slot
+};
+
+// Fixed set of flat element records owned by a widget, allocated once with
+// it. Displays hold slot numbers in drawing order, so a display that grows
+// takes slots another one gave back and nothing is ever allocated.
+class WebDataElementPool {
+   public:
+    WebDataElementPool();
+
+    int32_t acquire();
+    void release(uint16_t slot);
+    WebDataElement &get(uint16_t slot);
+    void reportDropped(int32_t count);
+    const WebDataPoolStats &getStats();
+    void printStats(const char *tag);
+
+   private:
+    WebDataElement m_elements[WEB_DATA_POOL_SLOTS];
+    uint16_t m_free[WEB_DATA_POOL_SLOTS];
+    uint16_t m_freeCount = 0;
+    WebDataPoolStats m_stats = {};
+    uint32_t m_unreported = 0;  // dropped since the last log line
+    unsigned long m_lastReport = 0;
+};
+#endif
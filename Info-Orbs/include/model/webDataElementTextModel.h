@@ -7,45 +7,11 @@
 #include "utils.h"
 #include "webDataElement.h"
 
-class WebDataElementTextModel : public WebDataElement {
+// Parses and draws "text" elements, their text is "text"
+class WebDataElementTextModel {
    public:
-    int32_t getX();
-    void setX(int32_t x);
-    int32_t getY();
-    void setY(int32_t y);
-
-    String getText();
-    void setText(String text);
-
-    int32_t getFont();
-    void setFont(int32_t font);
-
-    int32_t getSize();
-    void setSize(int32_t size);
-
-    int32_t getAlignment();
-    void setAlignment(int32_t alignment);
-    void setAlignment(String alignment);
-
-    int32_t getBackgroundColor();
-    void setBackgroundColor(int32_t background);
-    void setBackgroundColor(String background);
-
-    void setColor(int32_t color);
-    void setColor(String color);
-    int32_t getColor();
-
-    void parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground) override;
-    void draw(TFT_eSPI& display) override;
-
-   private:
-    int32_t m_x = 0;
-    int32_t m_y = 0;
-    String m_text;
-    int32_t m_font = 2;
-    int32_t m_size = 2;
-    int32_t m_alignment = MC_DATUM;
-    int32_t m_color = -1;
-    int32_t m_background = -1;
+    static const char* parseData(const JsonObject& doc, WebDataElement& element);
+    static void draw(const WebDataElement& element, const char* text, TFT_eSPI& display);
+    static WebDataBounds getBounds(const WebDataElement& element, const char* text, TFT_eSPI& display);
 };
 #endif
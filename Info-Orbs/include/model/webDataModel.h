@@ -3,31 +3,44 @@
 
 #include <ArduinoJson.h>
 #include <TFT_eSPI.h>
+#include <fixedString.h>
 
 #include "webDataElementModel.h"
+#include "webDataElementPool.h"
+
+#ifndef WEB_DATA_MAX_ELEMENTS
+#define WEB_DATA_MAX_ELEMENTS WEB_DATA_POOL_SLOTS  // per display, the records come from the widget's pool
+#endif
+#define WEB_DATA_TEXT_SIZE 1024        // bytes of interned element text per display
+#define WEB_DATA_MAX_DIRTY_REGIONS 16  // more invalidated areas than this repaint the whole display
+#define WEB_DATA_WRAP_BUFFER 256       // bytes of wrapped text in text data mode
+#define WEB_DATA_LABEL_LENGTH 32       // label above the data
+#define WEB_DATA_DATA_LENGTH 200       // "data" given as plain text, fits the wrap buffer
 
 class WebDataModel {
    public:
     virtual ~WebDataModel() = default;
-    String getLabel();
-    void setLabel(String label);
-    String getData();
-    void setData(String data, int32_t defaultColor, int32_t defaultBackground);
+    void setPool(WebDataElementPool* pool);
+    const FixedString<WEB_DATA_LABEL_LENGTH>& getLabel();
+    void setLabel(StringView label);
+    const FixedString<WEB_DATA_DATA_LENGTH>& getData();
+    void setData(StringView data, int32_t defaultColor, int32_t defaultBackground);
     void setData(JsonArray data, int32_t defaultColor, int32_t defaultBackground);
-    const WebDataElementModel& getElement(int index);
+    const WebDataElement& getElement(int index);
+    int32_t findElement(uint32_t id);
+    void applyDelta(const JsonObject& delta, int32_t defaultColor, int32_t defaultBackground);
     int32_t getElementsCount();
     void setElementsCount(int32_t elementsCount);
-    void initElements(int32_t count);
     // void setElements(WebDataElementModel *element);
     int32_t getLabelColor();
     void setLabelColor(int32_t color);
-    void setLabelColor(String color);
+    void setLabelColor(const char* color);
     int32_t getDataColor();
     void setDataColor(int32_t color);
-    void setDataColor(String color);
+    void setDataColor(const char* color);
     int32_t getBackgroundColor();
     void setBackgroundColor(int32_t background);
-    void setBackgroundColor(String background);
+    void setBackgroundColor(const char* background);
 
     bool isFullDraw();
     void setFullDrawStatus(bool fullDraw);
@@ -39,14 +52,30 @@ class WebDataModel {
     void setInitializedStatus(bool initialized);
 
     void parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground);
+    void refreshImages();
     void draw(TFT_eSPI& display);
 
    private:
+    WebDataElement& elementAt(int index);
+    void parseElement(WebDataElement& element, const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground, bool update);
+    const char* getText(uint16_t offset);
+    uint16_t internText(const char* text);
+    void compactText();
+    bool invalidate(const WebDataBounds& bounds);
+    bool isInvalidated(const WebDataBounds& bounds);
+
     bool m_isInitialized = false;
-    String m_label = "";
-    String m_data = "";
-    WebDataElementModel* m_elements = nullptr;
+    bool m_redrawAll = true;  // cleared after a draw, then only changed elements are repainted
+    WebDataBounds m_invalid[WEB_DATA_MAX_DIRTY_REGIONS];  // areas to erase and repaint on the next draw
+    int m_invalidCount = 0;
+    FixedString<WEB_DATA_LABEL_LENGTH> m_label;
+    FixedString<WEB_DATA_DATA_LENGTH> m_data;
+    WebDataElementPool* m_pool = nullptr;
+    uint16_t m_slots[WEB_DATA_MAX_ELEMENTS];  // pool slots in drawing order
     int m_elementsCount = 0;
+    int32_t m_truncatedFrom = 0;  // element count last reported as over WEB_DATA_MAX_ELEMENTS
+    char m_text[WEB_DATA_TEXT_SIZE];  // NUL terminated texts referenced by WebDataElement::text
+    uint16_t m_textUsed = 0;
     int32_t m_labelColor = -1;
     int32_t m_color = -1;
     int32_t m_background = -1;
@@ -2,17 +2,32 @@
 #define UTILS_H
 
 #include <Arduino.h>
+#include <ArduinoJson.h>
 #include <TFT_eSPI.h>
+#include <fixedString.h>
 
 #define MAX_WRAPPED_LINES 10
 
+typedef FixedString<24> FormattedFloat;  // dtostrf output of any value a widget shows
+
+// Heap state for soak runs, the low-water marks cover everything since boot
+struct HeapStats {
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+    uint32_t largestBlock;
+    uint32_t minLargestBlock;  // lowest largest block seen by getHeapStats
+    uint8_t fragmentation;     // percent of free heap outside the largest block
+};
+
 class Utils {
    public:
-    static int getWrappedLines(String (&lines)[MAX_WRAPPED_LINES], String str, int limit);
-    static String getWrappedLine(String str, int limit, int lineNum, int maxLines);
-    static int32_t stringToColor(String color);
-    static String formatFloat(float value, int8_t digits);
-    static int32_t stringToAlignment(String alignment);
+    static int32_t stringToColor(const char *color);
+    static int32_t stringToColor(const String &color);
+    static int32_t colorFromJson(JsonVariantConst value, int32_t defaultColor);
+    static FormattedFloat formatFloat(float value, int8_t digits);
+    static int32_t stringToAlignment(const char *alignment);
+    static HeapStats getHeapStats();
+    static void printHeapStats(const char *tag);
 };
 
 #endif
@@ -2,8 +2,14 @@
 #define CLOCKWIDGET_H
 
 #include <globalTime.h>
+#include <histogram.h>
+#include <sweepRing.h>
 #include <widget.h>
 
+#define CLOCK_REPORT_INTERVAL 600000    // how often redraw latency is logged (ms)
+#define CLOCK_SWEEP_FPS 30              // frame rate of the SHOW_SECOND_SWEEP ring
+#define CLOCK_SWEEP_FRAME_BUDGET 4000   // most time a sweep frame may take from the other orbs (us)
+
 class ClockWidget : public Widget {
    public:
     ClockWidget(ScreenManager& manager);
@@ -12,22 +18,27 @@ class ClockWidget : public Widget {
     void update(bool force = false) override;
     void draw(bool force = false) override;
     void changeMode() override;
+    const char *getName() override { return "clock"; }
+    float getSweepFps();
+    uint32_t getSweepDroppedFrames();
 
    private:
-    void displayDidget(int displayIndex, const String& didget, int font, int fontSize, uint32_t color, bool shadowing);
-    void displayDidget(int displayIndex, const String& didget, int font, int fontSize, uint32_t color);
+    void displayDidget(int displayIndex, const char* didget, int font, int fontSize, uint32_t color, bool shadowing);
+    void displayDidget(int displayIndex, const char* didget, int font, int fontSize, uint32_t color);
+    void displayDidget(int displayIndex, char didget, int font, int fontSize, uint32_t color);
     void displaySeconds(int displayIndex, int seconds, int color);
     void displayAmPm(uint32_t color);
 
     time_t m_unixEpoch;
     int m_timeZoneOffset;
 
-    // Delays for setting how often certain screens/functions are refreshed/checked. These include both the frequency which they need to be checked and a varibale to store the last checked value.
-    long m_secondTimer = 2000;  // this time is used to refressh/check the clock every second.
-    long m_secondTimerPrev = 0;
+    // Redraws happen when GlobalTime starts a new second, the latency is how far
+    // past that boundary the colon was drawn
+    time_t m_lastEpoch = 0;
+    Histogram m_redrawLatency;
+    unsigned long m_lastReport = 0;
 
-    // WiFiUDP m_udp;
-    // NTPClient* m_timeClient{ nullptr };
+    SweepRing m_sweep{SCREEN_SIZE / 2, SCREEN_SIZE / 2, 110, 120, CLOCK_SWEEP_FPS, CLOCK_SWEEP_FRAME_BUDGET};
 
     int m_minuteSingle;
     int m_hourSingle;
@@ -37,15 +48,15 @@ class ClockWidget : public Widget {
     int m_lastHourSingle{-1};
     int m_lastSecondSingle{-1};
 
-    // Didgets
-    String m_display1Didget;
-    String m_lastDisplay1Didget{"-1"};
-    String m_display2Didget;
-    String m_lastDisplay2Didget{"-1"};
+    // Didgets, '-' means not drawn yet
+    char m_display1Didget{' '};
+    char m_lastDisplay1Didget{'-'};
+    char m_display2Didget{' '};
+    char m_lastDisplay2Didget{'-'};
     // Display 3 is :
-    String m_display4Didget;
-    String m_lastDisplay4Didget{"-1"};
-    String m_display5Didget;
-    String m_lastDisplay5Didget{"-1"};
+    char m_display4Didget{' '};
+    char m_lastDisplay4Didget{'-'};
+    char m_display5Didget{' '};
+    char m_lastDisplay5Didget{'-'};
 };
 #endif  // CLOCKWIDGET_H
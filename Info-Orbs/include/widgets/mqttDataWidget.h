@@ -0,0 +1,67 @@
+#ifndef MQTT_DATA_WIDGET_H
+#define MQTT_DATA_WIDGET_H
+
+#include <ArduinoJson.h>
+#include <PubSubClient.h>
+#include <WiFi.h>
+#include <jsonArena.h>
+#include <widget.h>
+
+#include "model/webDataModel.h"
+#include "utils.h"
+
+#define MQTT_MAX_TOPICS 5
+#define MQTT_BUFFER_SIZE 4096      // largest payload the client will accept
+#define MQTT_JSON_ARENA 8192       // bytes for one parsed payload
+#define MQTT_KEEP_ALIVE 30         // seconds
+#define MQTT_RECONNECT_DELAY 5000  // ms between broker connection attempts
+#define MQTT_LATENCY_Y 226         // baseline of the latency label with MQTT_SHOW_LATENCY
+
+#ifndef MQTT_BROKER_PORT
+#define MQTT_BROKER_PORT 1883
+#endif
+
+// Subscribes to one topic per orb. Each payload is a single WebData display
+// and goes through the same WebDataModel parse/draw path as WebDataWidget.
+class MqttDataWidget : public Widget {
+   public:
+    MqttDataWidget(ScreenManager &manager, String host, String topics);
+    ~MqttDataWidget() override;
+    void setup() override;
+    void update(bool force = false) override;
+    void draw(bool force = false) override;
+    void changeMode() override;
+    const char *getName() override { return "mqtt"; }
+
+   private:
+    static void clientTask(void *param);
+    void onMessage(char *topic, byte *payload, unsigned int length);
+    bool reconnect();
+    void drawLatency(TFT_eSPI &display, unsigned long latency);
+
+    String m_host;
+    WiFiClient m_wifiClient;
+    PubSubClient m_client;
+    TaskHandle_t m_task = nullptr;
+    TaskHandle_t volatile m_stopper = nullptr;  // the task waiting in the destructor
+    volatile bool m_stopRequested = false;
+    SemaphoreHandle_t m_lock = nullptr;
+    unsigned long m_lastConnectAttempt = 0;
+
+    String m_topics[MQTT_MAX_TOPICS];
+    int8_t m_topicCount = 0;
+
+    // Latest unparsed payload per orb, a burst of messages only keeps the newest
+    String m_pending[MQTT_MAX_TOPICS];
+    bool m_hasPending[MQTT_MAX_TOPICS] = {false};
+    unsigned long m_receivedAt[MQTT_MAX_TOPICS] = {0};
+    unsigned long m_parsedReceivedAt[MQTT_MAX_TOPICS] = {0};
+
+    WebDataElementPool m_pool;
+    WebDataModel m_obj[MQTT_MAX_TOPICS];
+    uint32_t m_imageGeneration = 0;  // image cache generation the displays last looked up
+    StaticJsonArena<MQTT_JSON_ARENA> m_jsonArena{"MQTT"};
+    int32_t m_defaultColor = TFT_WHITE;
+    int32_t m_defaultBackground = TFT_BLACK;
+};
+#endif  // MQTT_DATA_WIDGET_H
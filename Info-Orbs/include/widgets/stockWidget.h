@@ -4,11 +4,14 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <TFT_eSPI.h>
+#include <jsonArena.h>
 
 #include "model/stockDataModel.h"
+#include "pollPolicy.h"
 #include "widget.h"
 
 #define MAX_STOCKS 5
+#define STOCK_JSON_ARENA 3072  // bytes for one parsed quote
 
 class StockWidget : public Widget {
    public:
@@ -17,14 +20,16 @@ class StockWidget : public Widget {
     void update(bool force = false) override;
     void draw(bool force = false) override;
     void changeMode() override;
+    const char *getName() override { return "stocks"; }
 
    private:
-    void getStockData(StockDataModel &stock);
+    bool getStockData(StockDataModel &stock);
     void displayStock(int8_t displayIndex, StockDataModel &stock, uint32_t backgroundColor, uint32_t textColor);
 
 
-    unsigned long m_stockDelay = 900000;  //default to 15m between updates
-    unsigned long m_stockDelayPrev = 0;
+    // 15m between updates to start with, stretched up to 1h while prices don't move
+    PollPolicy m_poll{900000, 300000, 3600000};
+    StaticJsonArena<STOCK_JSON_ARENA> m_jsonArena{"Stock"};
 
     StockDataModel m_stocks[MAX_STOCKS];
     int8_t m_stockCount;
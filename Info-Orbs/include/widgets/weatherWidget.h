@@ -6,11 +6,17 @@
 #include <TJpg_Decoder.h>
 #include <config.h>
 #include <globalTime.h>
+#include <jsonArena.h>
 #include <math.h>
+#include <pollPolicy.h>
 #include <widget.h>
 
 #include "model/weatherDataModel.h"
 
+#define WEATHER_TEXT_LINES 4    // lines of weather description
+#define WEATHER_TEXT_BUFFER 96  // bytes of wrapped city or description text
+#define WEATHER_JSON_ARENA 12288  // bytes for the parsed forecast
+
 class WeatherWidget : public Widget {
    public:
     WeatherWidget(ScreenManager& manager);
@@ -19,24 +25,26 @@ class WeatherWidget : public Widget {
     void update(bool force = false) override;
     void draw(bool force = false) override;
     void changeMode() override;
+    const char *getName() override { return "weather"; }
 
    private:
     void displayClock(int displayIndex, uint32_t background, uint32_t textColor);
 
     void showJPG(int displayIndex, int x, int y, const byte jpgData[], int size, int scale);
-    void drawWeatherIcon(String condition, int displayIndex, int x, int y, int scale);
+    void drawWeatherIcon(const char *condition, int displayIndex, int x, int y, int scale);
     void singleWeatherDeg(int displayIndex, uint32_t background, uint32_t textColor);
     void weatherText(int displayIndex, int16_t background, int16_t textColor);
     void threeDayWeather(int displayIndex);
     bool getWeatherData();
     int getClockStamp();
-    int drawDegrees(String number, int x, int y, uint8_t font, uint8_t size, uint8_t outerRadius, uint8_t innerRadius, int16_t textColor, int16_t backgroundColor);
+    int drawDegrees(const char *number, int x, int y, uint8_t font, uint8_t size, uint8_t outerRadius, uint8_t innerRadius, int16_t textColor, int16_t backgroundColor);
 
     GlobalTime* m_time;
     int8_t m_mode;
 
-    const long m_updateDelay = 600000;  // weather refresh rate
-    unsigned long m_lastUpdate = 0;
+    // weather refresh rate, 10m to start with and stretched up to 30m while nothing changes
+    PollPolicy m_poll{600000, 300000, 1800000};
+    StaticJsonArena<WEATHER_JSON_ARENA> m_jsonArena{"Weather"};
 
     const int centre = 120;  // centre location of the screen(240x240)
 
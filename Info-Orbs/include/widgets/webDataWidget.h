@@ -3,12 +3,22 @@
 
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
+#include <dataSource.h>
+#include <jsonArena.h>
+#include <memoryGovernor.h>
 #include <widget.h>
 
 #include "model/webDataModel.h"
 #include "utils.h"
 
-class WebDataWidget : public Widget {
+#define WEB_DATA_STREAM_TIMEOUT 60000     // reconnect if a push stream is silent for this long (ms)
+#define WEB_DATA_STREAM_RETRY_DELAY 3000  // default delay before reopening a dropped push stream (ms)
+#define WEB_DATA_STREAM_MAX_EVENT 16384   // pushed events larger than this are dropped
+#define WEB_DATA_HEAP_REPORT_INTERVAL 600000  // how often heap fragmentation is logged (ms)
+#define WEB_DATA_STREAM_ARENA 8192        // bytes for one parsed pushed event, only held while connected
+#define WEB_DATA_STREAM_MEMORY_PRIORITY 100  // polling still works without the stream
+
+class WebDataWidget : public Widget, public DataSubscriber, public MemoryConsumer {
    public:
     WebDataWidget(ScreenManager &manager, String url);
     ~WebDataWidget() override;
@@ -16,13 +26,47 @@ class WebDataWidget : public Widget {
     void update(bool force = false) override;
     void draw(bool force = false) override;
     void changeMode() override;
+    const char *getName() override { return "webdata"; }
+    void onData(const String &url, JsonDocument &doc) override;
+    void prepareRequest(HTTPClient &http, bool full) override;
+    bool releaseMemory() override;
 
    private:
-    int m_lastUpdate = 0;
+    void applyDocument(JsonDocument &doc);
+
+    static bool isStreamUrl(const String &url);
+    static String normalizeStreamUrl(const String &url);
+
+    void resync();
+    bool openStream();
+    void closeStream(bool reconnectNow = false);
+    void readStream();
+    void processStreamLine(String &line);
+    void dispatchStreamEvent();
+
     int m_updateDelay = 1000;
     String httpRequestAddress;
+    WebDataElementPool m_pool;  // declared first, the displays hold slots in it
     WebDataModel m_obj[5];
     int32_t m_defaultColor = TFT_WHITE;
     int32_t m_defaultBackground = TFT_BLACK;
+    unsigned long m_lastHeapReport = 0;
+    uint32_t m_imageGeneration = 0;  // image cache generation the displays last looked up
+    uint32_t m_seq = 0;      // seq of the last full document or delta, 0 when we have none
+
+    // Push mode (Server-Sent Events), polling is used while the stream is down
+    String m_streamAddress = "";
+    HTTPClient m_streamHttp;
+    WiFiClient *m_stream = nullptr;
+    String m_streamLine = "";
+    String m_streamData = "";
+    StaticJsonArena<WEB_DATA_STREAM_ARENA> *m_streamArena = nullptr;  // allocated while the stream is connected
+    String m_lastEventId = "";
+    unsigned long m_streamLastActivity = 0;
+    unsigned long m_streamRetryDelay = WEB_DATA_STREAM_RETRY_DELAY;
+    unsigned long m_streamRetryAt = 0;
+    bool m_dispatching = false;     // a pushed document lives in the arena
+    bool m_closeRequested = false;  // closeStream() was called meanwhile
+    bool m_reconnectNow = false;
 };
 #endif  // WEB_DATA_WIDGET_H
@@ -0,0 +1,58 @@
+#ifndef WORLD_CLOCK_WIDGET_H
+#define WORLD_CLOCK_WIDGET_H
+
+#include <TFT_eSPI.h>
+#include <globalTime.h>
+#include <memoryGovernor.h>
+#include <posixTimeZone.h>
+#include <widget.h>
+
+#define WORLD_CLOCK_MAX_CITIES 5
+#define WORLD_CLOCK_NAME_LENGTH 24
+#define WORLD_CLOCK_GLYPHS "0123456789:"
+#define WORLD_CLOCK_FONT 7
+#define WORLD_CLOCK_TIME_Y 96   // top of the digits
+#define WORLD_CLOCK_MEMORY_PRIORITY 10  // glyphs are rebuilt in a few ms
+
+// One city per orb, all derived from the single GlobalTime UTC epoch. Digits
+// come from 1 bit sprites rendered once, and an orb only pushes the glyphs
+// that changed when its minute rolls over, so five clocks ticking over
+// together stay cheap.
+class WorldClockWidget : public Widget, public MemoryConsumer {
+   public:
+    WorldClockWidget(ScreenManager &manager, const char *cities);
+    ~WorldClockWidget() override;
+    void setup() override;
+    void update(bool force = false) override;
+    void draw(bool force = false) override;
+    void changeMode() override;
+    const char *getName() override { return "world clock"; }
+    bool releaseMemory() override;
+
+   private:
+    struct City {
+        char name[WORLD_CLOCK_NAME_LENGTH];
+        PosixTimeZone zone;
+        time_t minute;       // local minutes since the epoch last drawn
+        char time[6];        // as drawn
+        char day[12];        // as drawn
+        char nextTime[6];
+        char nextDay[12];
+        bool changed;
+    };
+
+    bool addCity(const char *name, const char *zone);
+    void createGlyphs(TFT_eSPI &display);
+    void drawCity(int index, bool force);
+    void drawTime(TFT_eSPI &display, City &city, bool force);
+    int glyphWidth(const char *text);
+
+    City m_cities[WORLD_CLOCK_MAX_CITIES];
+    uint8_t m_cityCount = 0;
+
+    TFT_eSprite *m_glyphs[sizeof(WORLD_CLOCK_GLYPHS) - 1] = {};
+    int16_t m_glyphWidths[sizeof(WORLD_CLOCK_GLYPHS) - 1] = {};
+    int16_t m_glyphHeight = 0;
+};
+
+#endif  // WORLD_CLOCK_WIDGET_H
@@ -0,0 +1,35 @@
+#include "bootProfiler.h"
+
+#include <esp_timer.h>
+
+static portMUX_TYPE bootProfilerLock = portMUX_INITIALIZER_UNLOCKED;
+
+BootProfiler::Mark BootProfiler::m_marks[BOOT_PROFILER_MAX_MARKS];
+uint8_t BootProfiler::m_count = 0;
+bool BootProfiler::m_finished = false;
+
+void BootProfiler::mark(const char *phase, const char *detail) {
+    portENTER_CRITICAL(&bootProfilerLock);
+    if (!m_finished && m_count < BOOT_PROFILER_MAX_MARKS) {
+        m_marks[m_count++] = {phase, detail, (uint32_t)esp_timer_get_time()};
+    }
+    portEXIT_CRITICAL(&bootProfilerLock);
+}
+
+// Prints when each phase ended and how long after the previous one
+void BootProfiler::finish() {
+    portENTER_CRITICAL(&bootProfilerLock);
+    bool finished = m_finished;
+    m_finished = true;
+    portEXIT_CRITICAL(&bootProfilerLock);
+    if (finished) {
+        return;
+    }
+    Serial.println("Boot timeline        ms     step");
+    uint32_t previous = 0;
+    for (uint8_t i = 0; i < m_count; i++) {
+        const Mark &mark = m_marks[i];
+        Serial.printf("%-16s %8.1f %8.1f  %s\n", mark.phase, mark.micros / 1000.0, (mark.micros - previous) / 1000.0, mark.detail != nullptr ? mark.detail : "");
+        previous = mark.micros;
+    }
+}
@@ -0,0 +1,31 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <Arduino.h>
+
+#define BOOT_PROFILER_MAX_MARKS 24
+
+// Timestamps the phases of startup against esp_timer, which starts with the
+// app, and prints them as one timeline once boot is done. Safe to call from
+// any task, marks after the timeline was printed are ignored.
+//
+//     BootProfiler::mark("wifi connected");
+//     BootProfiler::mark("first data", widget->getName());
+class BootProfiler {
+   public:
+    static void mark(const char *phase, const char *detail = nullptr);
+    static void finish();
+
+   private:
+    struct Mark {
+        const char *phase;   // both must outlive the boot, e.g. literals
+        const char *detail;
+        uint32_t micros;
+    };
+
+    static Mark m_marks[BOOT_PROFILER_MAX_MARKS];
+    static uint8_t m_count;
+    static bool m_finished;
+};
+
+#endif
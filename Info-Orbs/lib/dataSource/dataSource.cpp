@@ -0,0 +1,215 @@
+#include "dataSource.h"
+
+#include <fetchPolicy.h>
+#include <heapAccounting.h>
+#include <inflateStream.h>
+
+DataSourceRegistry *DataSourceRegistry::m_instance = nullptr;
+
+static const uint32_t PARSE_BOUNDS[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000};
+static const uint32_t ALLOCATION_BOUNDS[] = {1, 5, 10, 20, 50, 100, 200};
+
+DataSourceRegistry::Source::Source() : parseMicros("parse", "us", PARSE_BOUNDS, sizeof(PARSE_BOUNDS) / sizeof(PARSE_BOUNDS[0])),
+                                       allocations("allocations", "", ALLOCATION_BOUNDS, sizeof(ALLOCATION_BOUNDS) / sizeof(ALLOCATION_BOUNDS[0])) {
+}
+
+DataSourceRegistry::DataSourceRegistry() {
+}
+
+DataSourceRegistry *DataSourceRegistry::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new DataSourceRegistry();
+    }
+    return m_instance;
+}
+
+// A subscriber joining a source that was already fetched gets the full state
+// with the next fetch, which is due right away
+bool DataSourceRegistry::subscribe(const String &url, DataSubscriber *subscriber, unsigned long interval) {
+    Source *source = find(url);
+    if (source == nullptr) {
+        if (m_sourceCount == DATA_SOURCE_MAX_SOURCES) {
+            Serial.println("DataSource: no room for " + url);
+            return false;
+        }
+        source = &m_sources[m_sourceCount++];
+        source->url = url;
+        source->subscriberCount = 0;
+        source->lastFetch = 0;
+        source->fetched = false;
+        source->full = true;
+        source->fetching = false;
+        source->fetches = 0;
+        source->deliveries = 0;
+        source->parseMicros.reset();
+        source->allocations.reset();
+        source->wireBytes = 0;
+        source->decodedBytes = 0;
+    } else if (source->subscriberCount == DATA_SOURCE_MAX_SUBSCRIBERS) {
+        Serial.println("DataSource: too many subscribers for " + url);
+        return false;
+    } else {
+        source->fetched = false;
+        source->full = true;
+    }
+    source->subscribers[source->subscriberCount] = subscriber;
+    source->intervals[source->subscriberCount] = interval;
+    source->subscriberCount++;
+    return true;
+}
+
+void DataSourceRegistry::unsubscribe(const String &url, DataSubscriber *subscriber) {
+    Source *source = find(url);
+    if (source == nullptr) {
+        return;
+    }
+    for (int i = 0; i < source->subscriberCount; i++) {
+        if (source->subscribers[i] == subscriber) {
+            for (int j = i + 1; j < source->subscriberCount; j++) {
+                source->subscribers[j - 1] = source->subscribers[j];
+                source->intervals[j - 1] = source->intervals[j];
+            }
+            source->subscriberCount--;
+            break;
+        }
+    }
+    if (source->subscriberCount == 0) {
+        int index = source - m_sources;
+        for (int i = index + 1; i < m_sourceCount; i++) {
+            m_sources[i - 1] = m_sources[i];
+        }
+        m_sourceCount--;
+    }
+}
+
+void DataSourceRegistry::setInterval(const String &url, DataSubscriber *subscriber, unsigned long interval) {
+    Source *source = find(url);
+    if (source == nullptr) {
+        return;
+    }
+    for (int i = 0; i < source->subscriberCount; i++) {
+        if (source->subscribers[i] == subscriber) {
+            source->intervals[i] = interval;
+        }
+    }
+}
+
+// Fetches the source if it is due and hands the document to all subscribers.
+// Returns true when this call fetched it.
+bool DataSourceRegistry::update(const String &url, bool force) {
+    Source *source = find(url);
+    if (source == nullptr || source->fetching) {
+        // a subscriber asking from inside the fan-out is already being served
+        return false;
+    }
+    if (!force && !isDue(*source)) {
+        return false;
+    }
+    return fetch(*source);
+}
+
+// Makes the source due on the next update, full asks the server for the whole state
+void DataSourceRegistry::refresh(const String &url, bool full) {
+    Source *source = find(url);
+    if (source == nullptr) {
+        return;
+    }
+    source->fetched = false;
+    if (full) {
+        source->full = true;
+    }
+}
+
+void DataSourceRegistry::printStatus() {
+    for (int i = 0; i < m_sourceCount; i++) {
+        Source &source = m_sources[i];
+        Serial.printf("DataSource %s: %d subscribers, every %lu ms, %u fetches for %u deliveries, %u wire bytes, %u decoded bytes\n", source.url.c_str(), source.subscriberCount, getInterval(source), source.fetches, source.deliveries, source.wireBytes, source.decodedBytes);
+        source.parseMicros.print();
+#ifdef HEAP_ACCOUNTING
+        source.allocations.print();
+#endif
+    }
+    m_jsonArena.printStats();
+}
+
+DataSourceRegistry::Source *DataSourceRegistry::find(const String &url) {
+    for (int i = 0; i < m_sourceCount; i++) {
+        if (m_sources[i].url == url) {
+            return &m_sources[i];
+        }
+    }
+    return nullptr;
+}
+
+bool DataSourceRegistry::isDue(Source &source) {
+    return !source.fetched || millis() - source.lastFetch >= getInterval(source);
+}
+
+// The tightest deadline of all subscribers
+unsigned long DataSourceRegistry::getInterval(Source &source) {
+    unsigned long interval = source.subscriberCount > 0 ? source.intervals[0] : 0;
+    for (int i = 1; i < source.subscriberCount; i++) {
+        interval = min(interval, source.intervals[i]);
+    }
+    return interval;
+}
+
+// Subscribers may refresh, subscribe or unsubscribe from onData, so the
+// source is looked up again once the document has been handed out
+bool DataSourceRegistry::fetch(Source &source) {
+    if (!FetchPolicy::getInstance()->allowRequest(source.url)) {
+        return false;
+    }
+    String url = source.url;
+    source.lastFetch = millis();
+    source.fetched = true;
+    HeapTagGuard httpTag("http");
+    HTTPClient http;
+    http.begin(url);
+    InflateStream::prepare(http);
+    source.subscribers[0]->prepareRequest(http, source.full);
+    int httpCode = http.GET();
+    FetchPolicy::getInstance()->reportResult(url, httpCode);
+    if (httpCode <= 0) {
+        Serial.printf("HTTP request failed, error: %s\n", http.errorToString(httpCode).c_str());
+        http.end();
+        return false;
+    }
+
+    JsonDocument doc(&m_jsonArena);
+    InflateStream body(http.getStream(), http.header("Content-Encoding"));
+    bool msgPack = url.indexOf("format=msgpack") != -1 || http.header("Content-Type").indexOf("msgpack") != -1;
+    unsigned long parseStart = micros();
+    DeserializationError error;
+    {
+        HeapTagGuard jsonTag("json");
+        error = msgPack ? deserializeMsgPack(doc, body) : deserializeJson(doc, body);
+    }
+    source.parseMicros.add(micros() - parseStart);
+    source.wireBytes += body.getWireBytes();
+    source.decodedBytes += body.getDecodedBytes();
+    http.end();
+    if (error) {
+        Serial.printf("%s() failed: %s\n", msgPack ? "deserializeMsgPack" : "deserializeJson", error.c_str());
+        m_jsonArena.printStats();
+        return false;
+    }
+
+    source.full = false;
+    source.fetches++;
+    source.fetching = true;
+    uint32_t allocations = HeapAccounting::getAllocationCount();
+    int count = source.subscriberCount;
+    DataSubscriber *subscribers[DATA_SOURCE_MAX_SUBSCRIBERS];
+    memcpy(subscribers, source.subscribers, sizeof(subscribers));
+    for (int i = 0; i < count; i++) {
+        subscribers[i]->onData(url, doc);
+    }
+    Source *current = find(url);
+    if (current != nullptr) {
+        current->fetching = false;
+        current->deliveries += count;
+        current->allocations.add(HeapAccounting::getAllocationCount() - allocations);
+    }
+    return true;
+}
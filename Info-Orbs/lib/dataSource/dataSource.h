@@ -0,0 +1,75 @@
+#ifndef DATA_SOURCE_H
+#define DATA_SOURCE_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <HTTPClient.h>
+#include <histogram.h>
+#include <jsonArena.h>
+
+#define DATA_SOURCE_MAX_SOURCES 8
+#define DATA_SOURCE_MAX_SUBSCRIBERS 4  // per source
+#define DATA_SOURCE_JSON_ARENA 16384   // bytes for the document being handed out, shared by all sources
+
+// Receives the parsed documents of a shared data source
+class DataSubscriber {
+   public:
+    virtual ~DataSubscriber() = default;
+    virtual void onData(const String &url, JsonDocument &doc) = 0;
+    // Only called on the first subscriber, full asks for the whole state rather than changes
+    virtual void prepareRequest(HTTPClient &http, bool full) {}
+};
+
+// Widgets subscribe to a URL instead of fetching it themselves. Each URL is
+// fetched and parsed once and the document is handed to every subscriber.
+// A source is due when the tightest subscriber interval has passed, so
+// subscribers that update in the same loop share a single request.
+class DataSourceRegistry {
+   public:
+    static DataSourceRegistry *getInstance();
+
+    bool subscribe(const String &url, DataSubscriber *subscriber, unsigned long interval);
+    void unsubscribe(const String &url, DataSubscriber *subscriber);
+    void setInterval(const String &url, DataSubscriber *subscriber, unsigned long interval);
+    bool update(const String &url, bool force = false);
+    void refresh(const String &url, bool full);
+
+    void printStatus();
+
+   private:
+    struct Source {
+        Source();
+
+        String url;
+        DataSubscriber *subscribers[DATA_SOURCE_MAX_SUBSCRIBERS];
+        unsigned long intervals[DATA_SOURCE_MAX_SUBSCRIBERS];
+        uint8_t subscriberCount;
+        unsigned long lastFetch;
+        bool fetched;
+        bool full;
+        bool fetching;
+        uint16_t fetches;
+        uint16_t deliveries;
+        // reported with printStatus() rather than on every fetch
+        Histogram parseMicros;
+        Histogram allocations;  // during the fan-out, only counted with HEAP_ACCOUNTING
+        uint32_t wireBytes;
+        uint32_t decodedBytes;
+    };
+
+    DataSourceRegistry();
+
+    Source *find(const String &url);
+    bool isDue(Source &source);
+    unsigned long getInterval(Source &source);
+    bool fetch(Source &source);
+
+    static DataSourceRegistry *m_instance;
+
+    Source m_sources[DATA_SOURCE_MAX_SOURCES];
+    int8_t m_sourceCount = 0;
+    // fetches run one at a time on the loop task, so one arena serves them all
+    StaticJsonArena<DATA_SOURCE_JSON_ARENA> m_jsonArena{"DataSource"};
+};
+
+#endif
@@ -0,0 +1,148 @@
+#include "fetchPolicy.h"
+
+FetchPolicy *FetchPolicy::m_instance = nullptr;
+
+FetchPolicy::FetchPolicy() {
+}
+
+FetchPolicy *FetchPolicy::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new FetchPolicy();
+    }
+    return m_instance;
+}
+
+// Returns false while the host is backing off. Once the backoff expires on an
+// open circuit exactly one caller gets through as the half-open probe, another
+// one only if no result was reported within FETCH_PROBE_TIMEOUT.
+bool FetchPolicy::allowRequest(const String &url) {
+    HostState *host = getHost(url);
+    if (host == nullptr) {
+        return true;
+    }
+    switch (host->state) {
+        case CIRCUIT_CLOSED:
+            return host->failures == 0 || (long)(millis() - host->retryAt) >= 0;
+        case CIRCUIT_OPEN:
+            if ((long)(millis() - host->retryAt) >= 0) {
+                host->probeAt = millis();
+                setState(host, CIRCUIT_HALF_OPEN);
+                return true;
+            }
+            return false;
+        case CIRCUIT_HALF_OPEN:
+            if (millis() - host->probeAt < FETCH_PROBE_TIMEOUT) {
+                // a probe is already in flight
+                return false;
+            }
+            // the probe's caller never reported back, don't stay shut for good
+            Serial.printf("FetchPolicy %s: no result from the probe, probing again\n", host->host);
+            host->probeAt = millis();
+            return true;
+    }
+    return true;
+}
+
+// Connection errors, 5xx and 429 count against the host, anything else means it is up
+void FetchPolicy::reportResult(const String &url, int httpCode) {
+    if (httpCode <= 0 || httpCode >= 500 || httpCode == 429) {
+        reportFailure(url);
+    } else {
+        reportSuccess(url);
+    }
+}
+
+void FetchPolicy::reportSuccess(const String &url) {
+    HostState *host = getHost(url);
+    if (host == nullptr) {
+        return;
+    }
+    host->failures = 0;
+    if (host->state != CIRCUIT_CLOSED) {
+        setState(host, CIRCUIT_CLOSED);
+    }
+}
+
+void FetchPolicy::reportFailure(const String &url) {
+    HostState *host = getHost(url);
+    if (host == nullptr) {
+        return;
+    }
+    if (host->failures < UINT16_MAX) {
+        host->failures++;
+    }
+    unsigned long backoff = FETCH_BACKOFF_BASE << min(host->failures - 1, 16);
+    backoff = min(backoff, (unsigned long)FETCH_BACKOFF_MAX);
+    // +-25% jitter so hosts that failed together don't retry together
+    backoff = backoff * random(75, 126) / 100;
+    host->retryAt = millis() + backoff;
+
+    if (host->state == CIRCUIT_HALF_OPEN || host->failures >= FETCH_CIRCUIT_THRESHOLD) {
+        setState(host, CIRCUIT_OPEN);
+    } else {
+        Serial.printf("FetchPolicy %s: failure %d, retry in %lums\n", host->host, host->failures, backoff);
+    }
+}
+
+void FetchPolicy::printStatus() {
+    Serial.println("FetchPolicy hosts:");
+    for (int8_t i = 0; i < m_hostCount; i++) {
+        HostState &host = m_hosts[i];
+        long retryIn = (long)(host.retryAt - millis());
+        Serial.printf("  %-32s %-9s failures: %d retry in: %lds\n", host.host, stateName(host.state), host.failures,
+                      host.failures > 0 && retryIn > 0 ? retryIn / 1000 : 0);
+    }
+}
+
+FetchPolicy::HostState *FetchPolicy::getHost(const String &url) {
+    int start = url.indexOf("://");
+    start = start == -1 ? 0 : start + 3;
+    int end = start;
+    while (end < url.length() && url[end] != '/' && url[end] != ':' && url[end] != '?') {
+        end++;
+    }
+    int length = min(end - start, FETCH_HOST_LENGTH - 1);
+    const char *name = url.c_str() + start;
+
+    for (int8_t i = 0; i < m_hostCount; i++) {
+        if (strncmp(m_hosts[i].host, name, length) == 0 && m_hosts[i].host[length] == '\0') {
+            return &m_hosts[i];
+        }
+    }
+    if (m_hostCount == FETCH_MAX_HOSTS) {
+        Serial.println("MAX FETCH HOSTS UNABLE TO TRACK " + url);
+        return nullptr;
+    }
+    HostState &host = m_hosts[m_hostCount++];
+    strncpy(host.host, name, length);
+    host.host[length] = '\0';
+    host.state = CIRCUIT_CLOSED;
+    host.failures = 0;
+    host.retryAt = 0;
+    host.probeAt = 0;
+    return &host;
+}
+
+void FetchPolicy::setState(HostState *host, FetchCircuitState state) {
+    host->state = state;
+    Serial.printf("FetchPolicy %s: circuit %s", host->host, stateName(state));
+    if (state == CIRCUIT_OPEN) {
+        Serial.printf(" after %d failures, probing in %lums", host->failures, host->retryAt - millis());
+    }
+    Serial.println();
+    if (state == CIRCUIT_OPEN) {
+        printStatus();
+    }
+}
+
+const char *FetchPolicy::stateName(FetchCircuitState state) {
+    switch (state) {
+        case CIRCUIT_CLOSED:
+            return "closed";
+        case CIRCUIT_OPEN:
+            return "open";
+        case CIRCUIT_HALF_OPEN:
+            return "half-open";
+    }
+    return "unknown";
+}
@@ -0,0 +1,55 @@
+#ifndef FETCH_POLICY_H
+#define FETCH_POLICY_H
+
+#include <Arduino.h>
+
+#define FETCH_MAX_HOSTS 8
+#define FETCH_HOST_LENGTH 48
+#define FETCH_BACKOFF_BASE 1000      // first retry delay (ms)
+#define FETCH_BACKOFF_MAX 300000     // retry delay cap (ms)
+#define FETCH_CIRCUIT_THRESHOLD 3    // consecutive failures before the circuit opens
+#define FETCH_PROBE_TIMEOUT 30000    // let another probe through if a probe's result never came (ms)
+
+enum FetchCircuitState {
+    CIRCUIT_CLOSED,
+    CIRCUIT_OPEN,
+    CIRCUIT_HALF_OPEN
+};
+
+// Shared per-host gate in front of every HTTP fetch. Failures push the next
+// allowed attempt out with exponential backoff and jitter. After repeated
+// failures the circuit opens and only a single half-open probe is let through
+// once the backoff has expired, so an outage costs no blocking requests.
+class FetchPolicy {
+   public:
+    static FetchPolicy *getInstance();
+
+    bool allowRequest(const String &url);
+    void reportResult(const String &url, int httpCode);
+    void reportSuccess(const String &url);
+    void reportFailure(const String &url);
+
+    void printStatus();
+
+   private:
+    struct HostState {
+        char host[FETCH_HOST_LENGTH];
+        FetchCircuitState state;
+        uint16_t failures;
+        unsigned long retryAt;
+        unsigned long probeAt;  // when the half-open probe was let through
+    };
+
+    FetchPolicy();
+
+    HostState *getHost(const String &url);
+    void setState(HostState *host, FetchCircuitState state);
+    static const char *stateName(FetchCircuitState state);
+
+    static FetchPolicy *m_instance;
+
+    HostState m_hosts[FETCH_MAX_HOSTS];
+    int8_t m_hostCount = 0;
+};
+
+#endif
@@ -0,0 +1,29 @@
+#include "fixedString.h"
+
+namespace fixedString {
+
+size_t fit(StringView value, size_t capacity) {
+    if (value.length() <= capacity) {
+        return value.length();
+    }
+    return trimPartial(value.data(), capacity);
+}
+
+size_t trimPartial(const char *text, size_t length) {
+    size_t start = length;
+    while (start > 0 && ((uint8_t)text[start - 1] & 0xC0) == 0x80) {
+        start--;
+    }
+    if (start == 0) {
+        return length;
+    }
+    uint8_t lead = text[start - 1];
+    size_t expected = lead < 0xC0 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+    return length - (start - 1) < expected ? start - 1 : length;
+}
+
+void reportTruncation(const char *field, StringView value, size_t capacity) {
+    Serial.printf("%s truncated to %u of %u bytes: %.*s\n", field, (unsigned)fit(value, capacity), (unsigned)value.length(), (int)value.length(), value.data());
+}
+
+}  // namespace fixedString
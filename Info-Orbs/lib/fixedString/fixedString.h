@@ -0,0 +1,115 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Characters owned by someone else plus their length, cheap to pass by value.
+// Not necessarily NUL terminated, use FixedString when a C string is needed.
+class StringView {
+   public:
+    constexpr StringView() : m_data(""), m_length(0) {}
+    constexpr StringView(const char *data, size_t length) : m_data(data), m_length(length) {}
+    StringView(const char *text) : m_data(text != nullptr ? text : ""), m_length(text != nullptr ? strlen(text) : 0) {}
+    StringView(const String &text) : m_data(text.c_str()), m_length(text.length()) {}
+
+    const char *data() const { return m_data; }
+    size_t length() const { return m_length; }
+    bool isEmpty() const { return m_length == 0; }
+
+    // Everything before the first c, the whole view when there is none
+    StringView before(char c) const {
+        const char *found = (const char *)memchr(m_data, c, m_length);
+        return found != nullptr ? StringView(m_data, found - m_data) : *this;
+    }
+
+    bool operator==(StringView other) const {
+        return m_length == other.m_length && memcmp(m_data, other.m_data, m_length) == 0;
+    }
+    bool operator!=(StringView other) const { return !(*this == other); }
+
+   private:
+    const char *m_data;
+    size_t m_length;
+};
+
+namespace fixedString {
+// Longest prefix of value that fits, without splitting a UTF-8 sequence
+size_t fit(StringView value, size_t capacity);
+// Drops a UTF-8 sequence cut off at the end of text
+size_t trimPartial(const char *text, size_t length);
+void reportTruncation(const char *field, StringView value, size_t capacity);
+}  // namespace fixedString
+
+// Inline string of up to N bytes that never touches the heap. Values that
+// don't fit are cut at the last whole character that does.
+//
+//     FixedString<24> icon;
+//     if (icon.set(doc["icon"].as<const char *>(), "weather icon")) { ...changed... }
+template <size_t N>
+class FixedString {
+   public:
+    FixedString() { clear(); }
+    FixedString(StringView value) { assign(value); }
+
+    // Copies value, false when it had to be truncated
+    bool assign(StringView value) {
+        m_length = fixedString::fit(value, N);
+        memcpy(m_text, value.data(), m_length);
+        m_text[m_length] = '\0';
+        return m_length == value.length();
+    }
+
+    // Model setter helper: true when the stored value changed, reports
+    // truncation under field name once per change rather than per refresh
+    bool set(StringView value, const char *field) {
+        size_t length = fixedString::fit(value, N);
+        if (length == m_length && memcmp(m_text, value.data(), length) == 0) {
+            return false;
+        }
+        if (!assign(value)) {
+            fixedString::reportTruncation(field, value, N);
+        }
+        return true;
+    }
+
+    // printf into the buffer, false when the result was truncated
+    bool format(const char *format, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, format);
+        int length = vsnprintf(m_text, N + 1, format, args);
+        va_end(args);
+        if (length < 0) {
+            clear();
+            return false;
+        }
+        if ((size_t)length <= N) {
+            m_length = length;
+            return true;
+        }
+        m_length = fixedString::trimPartial(m_text, N);
+        m_text[m_length] = '\0';
+        return false;
+    }
+
+    void clear() {
+        m_length = 0;
+        m_text[0] = '\0';
+    }
+
+    const char *c_str() const { return m_text; }
+    size_t length() const { return m_length; }
+    bool isEmpty() const { return m_length == 0; }
+    static constexpr size_t capacity() { return N; }
+    StringView view() const { return StringView(m_text, m_length); }
+    operator StringView() const { return view(); }
+
+    bool operator==(StringView other) const { return view() == other; }
+    bool operator!=(StringView other) const { return view() != other; }
+
+   private:
+    char m_text[N + 1];
+    uint16_t m_length;
+};
+
+#endif
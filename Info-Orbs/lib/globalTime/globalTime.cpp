@@ -1,18 +1,48 @@
 #include "globalTime.h"
 
 #include <TimeLib.h>
+#include <bootProfiler.h>
 #include <config.h>
+#include <esp_sntp.h>
+#include <esp_timer.h>
+#include <heapAccounting.h>
+#include <sys/time.h>
+
+#include "timeZones.h"
+
+#ifdef TIMEZONE_POSIX
+static constexpr const char *GLOBAL_TIME_ZONE = TIMEZONE_POSIX;
+#else
+static constexpr const char *GLOBAL_TIME_ZONE = findTimeZone(TIMEZONE_API_LOCATION);
+static_assert(GLOBAL_TIME_ZONE != nullptr, "TIMEZONE_API_LOCATION is not in timeZones.h, set TIMEZONE_POSIX in config.h");
+#endif
+
+static const uint32_t SYNC_ERROR_BOUNDS[] = {1, 2, 5, 10, 20, 50, 100, 200, 500, 1000};
 
 GlobalTime *GlobalTime::m_instance = nullptr;
 
-GlobalTime::GlobalTime() {
-    m_timeClient = new NTPClient(m_udp);
-    m_timeClient->begin();
-    m_timeClient->setPoolServerName(NTP_SERVER);
+// SNTP keeps the system clock in UTC, the TZ rule turns that into local time
+GlobalTime::GlobalTime() : m_syncErrors("SNTP error", "ms", SYNC_ERROR_BOUNDS, sizeof(SYNC_ERROR_BOUNDS) / sizeof(SYNC_ERROR_BOUNDS[0])) {
+    // start from whatever the RTC kept over a reset
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    m_slewedAt = esp_timer_get_time();
+    m_offset = (int64_t)tv.tv_sec * 1000000 + tv.tv_usec - m_slewedAt;
+    m_targetOffset = m_offset;
+    m_syncedAt = m_slewedAt;
+
+    sntp_set_sync_mode(SNTP_SYNC_MODE_SMOOTH);
+    sntp_set_sync_interval(GLOBAL_TIME_SYNC_INTERVAL);
+    sntp_set_time_sync_notification_cb(onSync);
+    configTzTime(GLOBAL_TIME_ZONE, NTP_SERVER);
+#ifdef TIMEZONE_POSIX
+    Serial.printf("Timezone: %s\n", GLOBAL_TIME_ZONE);
+#else
+    Serial.printf("Timezone %s: %s\n", TIMEZONE_API_LOCATION, GLOBAL_TIME_ZONE);
+#endif
 }
 
 GlobalTime::~GlobalTime() {
-    delete m_timeClient;
 }
 
 GlobalTime *GlobalTime::getInstance() {
@@ -22,117 +52,261 @@ GlobalTime *GlobalTime::getInstance() {
     return m_instance;
 }
 
+// Cheap enough to call every loop, so a new second is picked up as soon as it starts
 void GlobalTime::updateTime() {
-    if (millis() - m_updateTimer > m_oneSecond) {
-        if (m_timeZoneOffset == -1) {
-            getTimeZoneOffsetFromAPI();
-        }
-        m_timeClient->update();
-        m_unixEpoch = m_timeClient->getEpochTime();
-        m_updateTimer = millis();
-        m_minute = minute(m_unixEpoch);
-        if (m_format24hour) {
-            m_hour = hour(m_unixEpoch);
-        } else {
-            m_hour = hourFormat12(m_unixEpoch);
-        }
-        m_second = second(m_unixEpoch);
-
-        m_day = day(m_unixEpoch);
-        m_month = month(m_unixEpoch);
-        m_monthName = monthStr(m_month);
-        m_year = year(m_unixEpoch);
-        m_weekday = dayStr(weekday(m_unixEpoch));
-        m_time = String(m_hour) + ":" + (m_minute < 10 ? "0" + String(m_minute) : String(m_minute));
+    time_t utc = getEpochMillis() / 1000;
+    if (utc != m_now.utcEpoch) {
+#ifdef HEAP_ACCOUNTING
+        uint32_t allocations = HeapAccounting::getAllocationCount();
+#else
+        size_t heapBefore = ESP.getFreeHeap();
+#endif
+        unsigned long start = micros();
+        tick(utc, false);
+        m_tickMicros += micros() - start;
+#ifdef HEAP_ACCOUNTING
+        m_allocations += HeapAccounting::getAllocationCount() - allocations;
+#else
+        m_heapChange += (int32_t)ESP.getFreeHeap() - (int32_t)heapBefore;
+#endif
+        m_ticks++;
+    }
+    if (m_syncPending) {
+        reportSync();
+    }
+    if (millis() - m_lastReport >= GLOBAL_TIME_REPORT_INTERVAL) {
+        reportTicks();
     }
 }
 
-void GlobalTime::getHourAndMinute(int &hour, int &minute) {
-    hour = m_hour;
-    minute = m_minute;
+// Milliseconds since the epoch in UTC, never goes backwards once synced
+int64_t GlobalTime::getEpochMillis() {
+    return getEpochMicros() / 1000;
 }
 
-int GlobalTime::getHour() {
-    return m_hour;
+// Moves the offset at most GLOBAL_TIME_MAX_SLEW towards the drift corrected
+// target. That is far less than the time passing, so the clock stays monotonic.
+int64_t GlobalTime::getEpochMicros() {
+    portENTER_CRITICAL(&m_clockLock);
+    int64_t now = esp_timer_get_time();
+    int64_t target = m_targetOffset + (int64_t)(m_drift * (now - m_syncedAt));
+    int64_t maxSlew = (now - m_slewedAt) * GLOBAL_TIME_MAX_SLEW / 1000000;
+    int64_t error = target - m_offset;
+    m_offset += error > maxSlew ? maxSlew : (error < -maxSlew ? -maxSlew : error);
+    m_slewedAt = now;
+    int64_t epoch = now + m_offset;
+    portEXIT_CRITICAL(&m_clockLock);
+    return epoch;
 }
 
-String GlobalTime::getHourPadded() {
-    if (m_hour < 10) {
-        return "0" + String(m_hour);
-    } else {
-        return String(m_hour);
+// Called by the SNTP client from the lwIP task
+void GlobalTime::onSync(struct timeval *tv) {
+    if (m_instance != nullptr) {
+        m_instance->discipline((int64_t)tv->tv_sec * 1000000 + tv->tv_usec);
     }
 }
 
-int GlobalTime::getMinute() {
-    return m_minute;
+// Records how far off we were and retargets the offset. Small errors are
+// slewed away and teach the drift estimate, large ones (the first sync) are
+// stepped.
+void GlobalTime::discipline(int64_t reference) {
+    int64_t model = getEpochMicros();
+    portENTER_CRITICAL(&m_clockLock);
+    int64_t now = esp_timer_get_time();
+    int64_t error = model - reference;
+    int64_t target = reference - now;
+    bool first = !m_synced;
+    if (!m_synced || error > GLOBAL_TIME_STEP_LIMIT || error < -GLOBAL_TIME_STEP_LIMIT) {
+        m_offset = target;
+        m_drift = 0;
+    } else if (now > m_syncedAt) {
+        // whatever the last target missed by is rate error we haven't corrected yet
+        double predicted = m_targetOffset + m_drift * (now - m_syncedAt);
+        m_drift += (target - predicted) / (now - m_syncedAt) / 2;
+        m_drift = constrain(m_drift, -GLOBAL_TIME_MAX_DRIFT, GLOBAL_TIME_MAX_DRIFT);
+    }
+    m_targetOffset = target;
+    m_syncedAt = now;
+    m_slewedAt = now;
+    m_syncError = m_synced ? error : 0;
+    m_syncPending = m_synced;
+    m_synced = true;
+    portEXIT_CRITICAL(&m_clockLock);
+    if (first) {
+        BootProfiler::mark("time synced");
+    }
+}
+
+// Logs on the loop task how far the displayed time was from SNTP at each sync
+void GlobalTime::reportSync() {
+    portENTER_CRITICAL(&m_clockLock);
+    int64_t error = m_syncError;
+    double drift = m_drift;
+    m_syncPending = false;
+    portEXIT_CRITICAL(&m_clockLock);
+    m_syncErrors.add(abs(error) / 1000);
+    Serial.printf("SNTP sync: clock was %lld us %s, drift %.1f ppm\n", (long long)abs(error), error > 0 ? "ahead" : "behind", drift * 1000000);
+    m_syncErrors.print();
 }
 
-String GlobalTime::getMinutePadded() {
-    if (m_minute < 10) {
-        return "0" + String(m_minute);
+// Within a minute only the seconds move, everything else is recomputed when
+// the minute rolls over. Offsets are whole minutes so DST changes land there.
+void GlobalTime::tick(time_t utc, bool full) {
+    beginWrite();
+    if (!full && utc > m_now.utcEpoch && utc / 60 == m_now.utcEpoch / 60) {
+        m_now.unixEpoch += utc - m_now.utcEpoch;
+        m_now.utcEpoch = utc;
+        m_now.second = utc % 60;
     } else {
-        return String(m_minute);
+        recompute(utc);
     }
+    endWrite();
+}
+
+// Formats only the fields that changed, straight into the snapshot buffers
+void GlobalTime::recompute(time_t utc) {
+    struct tm local;
+    localtime_r(&utc, &local);
+    m_recomputes++;
+
+    // TimeLib style epoch in local time, callers use it with TimeLib functions
+    tmElements_t elements;
+    elements.Second = local.tm_sec;
+    elements.Minute = local.tm_min;
+    elements.Hour = local.tm_hour;
+    elements.Day = local.tm_mday;
+    elements.Month = local.tm_mon + 1;
+    elements.Year = local.tm_year + 1900 - 1970;
+    m_now.utcEpoch = utc;
+    m_now.unixEpoch = makeTime(elements);
+    m_now.second = local.tm_sec;
+    m_now.pm = local.tm_hour >= 12;
+
+    int hour = local.tm_hour;
+    if (!m_format24hour) {
+        hour = hour % 12 == 0 ? 12 : hour % 12;
+    }
+    bool timeChanged = hour != m_now.hour || local.tm_min != m_now.minute || m_now.time[0] == '\0';
+    if (timeChanged) {
+        m_now.hour = hour;
+        m_now.minute = local.tm_min;
+        snprintf(m_now.hourPadded, sizeof(m_now.hourPadded), "%02d", hour);
+        snprintf(m_now.minutePadded, sizeof(m_now.minutePadded), "%02d", local.tm_min);
+        snprintf(m_now.time, sizeof(m_now.time), "%d:%02d", hour, local.tm_min);
+    }
+    if (local.tm_mday != m_now.day || local.tm_mon + 1 != m_now.month || local.tm_year + 1900 != m_now.year) {
+        m_now.day = local.tm_mday;
+        m_now.month = local.tm_mon + 1;
+        m_now.year = local.tm_year + 1900;
+        strlcpy(m_now.monthName, monthStr(m_now.month), sizeof(m_now.monthName));
+        strlcpy(m_now.weekday, dayStr(local.tm_wday + 1), sizeof(m_now.weekday));
+    }
+}
+
+// Seqlock writer, the count is odd while the snapshot is being changed
+void GlobalTime::beginWrite() {
+    m_seq.store(m_seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void GlobalTime::endWrite() {
+    m_seq.store(m_seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+// Lock free copy of the current time that is safe to take from another core,
+// retries when updateTime changed the snapshot while it was being copied
+void GlobalTime::getSnapshot(TimeSnapshot &snapshot) {
+    uint32_t seq;
+    do {
+        seq = m_seq.load(std::memory_order_acquire);
+        memcpy(&snapshot, &m_now, sizeof(snapshot));
+        std::atomic_thread_fence(std::memory_order_acquire);
+    } while ((seq & 1) != 0 || seq != m_seq.load(std::memory_order_relaxed));
+}
+
+// With HEAP_ACCOUNTING every malloc during a tick is counted, also ones freed
+// again before it ends. Other tasks allocating meanwhile are counted as well.
+// Without it only the change in free heap is left, which misses short-lived blocks.
+void GlobalTime::reportTicks() {
+    if (m_ticks > 0) {
+#ifdef HEAP_ACCOUNTING
+        Serial.printf("GlobalTime: %u ticks, %u recomputed, %u us per tick, %u allocations\n", m_ticks, m_recomputes, m_tickMicros / m_ticks, m_allocations);
+#else
+        Serial.printf("GlobalTime: %u ticks, %u recomputed, %u us per tick, heap change %d bytes\n", m_ticks, m_recomputes, m_tickMicros / m_ticks, m_heapChange);
+#endif
+    }
+    m_lastReport = millis();
+    m_ticks = 0;
+    m_recomputes = 0;
+    m_tickMicros = 0;
+    m_allocations = 0;
+    m_heapChange = 0;
+}
+
+void GlobalTime::getHourAndMinute(int &hour, int &minute) {
+    hour = m_now.hour;
+    minute = m_now.minute;
+}
+
+int GlobalTime::getHour() {
+    return m_now.hour;
+}
+
+const char *GlobalTime::getHourPadded() {
+    return m_now.hourPadded;
+}
+
+int GlobalTime::getMinute() {
+    return m_now.minute;
+}
+
+const char *GlobalTime::getMinutePadded() {
+    return m_now.minutePadded;
 }
 
 int GlobalTime::getSecond() {
-    return m_second;
+    return m_now.second;
 }
 
 time_t GlobalTime::getUnixEpoch() {
-    return m_unixEpoch;
+    return m_now.unixEpoch;
+}
+
+time_t GlobalTime::getUtcEpoch() {
+    return m_now.utcEpoch;
 }
 
 int GlobalTime::getDay() {
-    return m_day;
+    return m_now.day;
 }
 
 int GlobalTime::getMonth() {
-    return m_month;
+    return m_now.month;
 }
 
-String GlobalTime::getMonthName() {
-    return m_monthName;
+const char *GlobalTime::getMonthName() {
+    return m_now.monthName;
 }
 
 int GlobalTime::getYear() {
-    return m_year;
+    return m_now.year;
 }
 
-String GlobalTime::getTime() {
-    return m_time;
+const char *GlobalTime::getTime() {
+    return m_now.time;
 }
 
-String GlobalTime::getWeekday() {
-    return m_weekday;
+const char *GlobalTime::getWeekday() {
+    return m_now.weekday;
 }
 
-#include <HTTPClient.h> // Include the necessary header file
-
 bool GlobalTime::isPM() {
-    return hour(m_unixEpoch) >= 12;
-}
-
-void GlobalTime::getTimeZoneOffsetFromAPI() {
-    HTTPClient http;
-    http.begin(String(TIMEZONE_API_URL) + "?key=" + TIMEZONE_API_KEY + "&format=json&fields=gmtOffset&by=zone&zone=" + String(TIMEZONE_API_LOCATION));
-    int httpCode = http.GET();
-
-    if (httpCode > 0) {
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, http.getString());
-        if (!error) {
-            m_timeZoneOffset = doc["gmtOffset"].as<int>();
-            Serial.print("Timezone Offset from API: ");
-            Serial.println(m_timeZoneOffset);
-            m_timeClient->setTimeOffset(m_timeZoneOffset);
-        } else {
-            Serial.println("Deserialization error on timezone offset API response");
-        }
-    } else {
-        Serial.println("Failed to get timezone offset from API");
-    }
+    return m_now.pm;
+}
+
+// True once SNTP set the clock, before that it runs from whatever the RTC kept
+bool GlobalTime::isSynced() {
+    return m_synced;
 }
 
 bool GlobalTime::getFormat24Hour() {
@@ -141,5 +315,7 @@ bool GlobalTime::getFormat24Hour() {
 
 bool GlobalTime::setFormat24Hour(bool format24hour) {
     m_format24hour = format24hour;
+    // the hour fields depend on the format
+    tick(m_now.utcEpoch, true);
     return m_format24hour;
-}
\ No newline at end of file
+}
@@ -1,31 +1,60 @@
 #ifndef TIME_H
 #define TIME_H
 
-#include <NTPClient.h>
+#include <Arduino.h>
 #include <TimeLib.h>
-#include <ArduinoJson.h>
-#include <HTTPClient.h>
+#include <atomic>
 #include <config.h>
+#include <histogram.h>
+
+#define GLOBAL_TIME_NAME_LENGTH 10           // "Wednesday" and "September" plus the terminator
+#define GLOBAL_TIME_REPORT_INTERVAL 60000    // how often tick statistics are logged (ms)
+#define GLOBAL_TIME_SYNC_INTERVAL 900000     // SNTP poll interval (ms)
+#define GLOBAL_TIME_MAX_SLEW 500             // fastest the clock is pulled towards SNTP (us per second)
+#define GLOBAL_TIME_MAX_DRIFT 0.0005         // largest oscillator drift we correct for
+#define GLOBAL_TIME_STEP_LIMIT 1000000       // errors above this are stepped instead of slewed (us)
+
+// Everything GlobalTime knows about the current time, formatted once per change
+struct TimeSnapshot {
+    time_t utcEpoch;
+    time_t unixEpoch;  // local time as a TimeLib epoch
+    int16_t year;
+    int8_t month;
+    int8_t day;
+    int8_t hour;  // 12 or 24 hour depending on the format
+    int8_t minute;
+    int8_t second;
+    bool pm;
+    char hourPadded[3];
+    char minutePadded[3];
+    char time[6];
+    char monthName[GLOBAL_TIME_NAME_LENGTH];
+    char weekday[GLOBAL_TIME_NAME_LENGTH];
+};
 
 class GlobalTime {
    public:
     static GlobalTime *getInstance();
 
     void updateTime();
+    int64_t getEpochMillis();
+    void getSnapshot(TimeSnapshot &snapshot);
     void getHourAndMinute(int &hour, int &minute);
     int getHour();
-    String getHourPadded();
+    const char *getHourPadded();
     int getMinute();
-    String getMinutePadded();
+    const char *getMinutePadded();
     time_t getUnixEpoch();
+    time_t getUtcEpoch();
     int getSecond();
     int getDay();
     int getMonth();
-    String getMonthName();
+    const char *getMonthName();
     int getYear();
-    String getTime();
-    String getWeekday();
+    const char *getTime();
+    const char *getWeekday();
     bool isPM();
+    bool isSynced();
     bool getFormat24Hour();
     bool setFormat24Hour(bool format24hour);
 
@@ -33,29 +62,43 @@ class GlobalTime {
     GlobalTime();
     ~GlobalTime();
 
-    static GlobalTime *m_instance;
+    static void onSync(struct timeval *tv);
+    void discipline(int64_t reference);
+    int64_t getEpochMicros();
+    void reportSync();
+    void tick(time_t utc, bool full);
+    void recompute(time_t utc);
+    void beginWrite();
+    void endWrite();
+    void reportTicks();
 
-    time_t m_unixEpoch;
-    int m_hour = 0;
-    int m_minute = 0;
-    int m_second = 0;
-    int m_day = 0;
-    int m_month = 0;
-    String m_monthName;
-    int m_year = 0;
-    String m_time;
-    String m_weekday;
-    int m_timeZoneOffset = -1; // a value that will be overwritten by the API
+    static GlobalTime *m_instance;
 
-    WiFiUDP m_udp;
-    NTPClient *m_timeClient{nullptr};
+    // Written by updateTime on the loop task, other tasks read it through getSnapshot
+    TimeSnapshot m_now = {};
+    std::atomic<uint32_t> m_seq{0};
 
-    const int m_oneSecond{1000};
-    int m_updateTimer{0};
+    // UTC is esp_timer plus an offset that is slewed towards the SNTP reference,
+    // drift is the rate error of esp_timer estimated from successive syncs
+    portMUX_TYPE m_clockLock = portMUX_INITIALIZER_UNLOCKED;
+    int64_t m_offset = 0;
+    int64_t m_targetOffset = 0;
+    int64_t m_syncedAt = 0;
+    int64_t m_slewedAt = 0;
+    double m_drift = 0;
+    bool m_synced = false;
+    bool m_syncPending = false;
+    int64_t m_syncError = 0;
+    Histogram m_syncErrors;
 
     bool m_format24hour{FORMAT_24_HOUR};
 
-    void getTimeZoneOffsetFromAPI();
+    uint32_t m_ticks = 0;
+    uint32_t m_recomputes = 0;
+    uint32_t m_tickMicros = 0;
+    uint32_t m_allocations = 0;  // counted with HEAP_ACCOUNTING
+    int32_t m_heapChange = 0;    // otherwise the free heap change is all we have
+    unsigned long m_lastReport = 0;
 };
 
 #endif
@@ -0,0 +1,168 @@
+#include "posixTimeZone.h"
+
+#include <ctype.h>
+#include <string.h>
+
+// Days since 1970-01-01 of a proleptic Gregorian date
+static int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    int yearOfEra = year - era * 400;
+    int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+static int yearFromDays(int64_t days) {
+    days += 719468;
+    int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    int dayOfEra = days - era * 146097;
+    int yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    int dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int monthIndex = (5 * dayOfYear + 2) / 153;
+    return yearOfEra + era * 400 + (monthIndex >= 10);
+}
+
+static int daysInMonth(int year, int month) {
+    static const uint8_t days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : days[month - 1];
+}
+
+// Returns false when the rule isn't understood, the zone is left at UTC then
+bool PosixTimeZone::parse(const char *rule) {
+    m_stdOffset = 0;
+    m_hasDst = false;
+    int32_t offset;
+    const char *p = parseName(rule);
+    if (p == nullptr || (p = parseTime(p, offset)) == nullptr) {
+        return false;
+    }
+    // POSIX offsets count west of UTC
+    int32_t stdOffset = -offset;
+    if (*p == '\0') {
+        m_stdOffset = stdOffset;
+        return true;
+    }
+    if ((p = parseName(p)) == nullptr) {
+        return false;
+    }
+    int32_t dstOffset = stdOffset + 3600;
+    if (*p != ',') {
+        if ((p = parseTime(p, offset)) == nullptr) {
+            return false;
+        }
+        dstOffset = -offset;
+    }
+    if (*p != ',' || (p = parseTransition(p + 1, m_start)) == nullptr || *p != ',' || (p = parseTransition(p + 1, m_end)) == nullptr || *p != '\0') {
+        return false;
+    }
+    m_stdOffset = stdOffset;
+    m_dstOffset = dstOffset;
+    m_hasDst = true;
+    return true;
+}
+
+// Seconds east of UTC in force at utc
+int32_t PosixTimeZone::getOffset(time_t utc) {
+    if (!m_hasDst) {
+        return m_stdOffset;
+    }
+    int64_t local = (int64_t)utc + m_stdOffset;
+    int year = yearFromDays(local >= 0 ? local / 86400 : (local - 86399) / 86400);
+    // DST starts on standard time and ends on daylight time
+    int64_t start = transitionTime(year, m_start) - m_stdOffset;
+    int64_t end = transitionTime(year, m_end) - m_dstOffset;
+    bool dst;
+    if (start < end) {
+        dst = utc >= start && utc < end;
+    } else {
+        // southern hemisphere, or a "DST" that is really winter time
+        dst = utc < end || utc >= start;
+    }
+    return dst ? m_dstOffset : m_stdOffset;
+}
+
+time_t PosixTimeZone::toLocal(time_t utc) {
+    return utc + getOffset(utc);
+}
+
+// Either an alphabetic name of three or more letters or a quoted <...> one
+const char *PosixTimeZone::parseName(const char *p) {
+    if (*p == '<') {
+        p = strchr(p, '>');
+        return p == nullptr ? nullptr : p + 1;
+    }
+    const char *start = p;
+    while (isalpha(*p)) {
+        p++;
+    }
+    return p - start >= 3 ? p : nullptr;
+}
+
+// [+-]hh[:mm[:ss]] in seconds
+const char *PosixTimeZone::parseTime(const char *p, int32_t &seconds) {
+    int32_t sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = *p == '-' ? -1 : 1;
+        p++;
+    }
+    if (!isdigit(*p)) {
+        return nullptr;
+    }
+    int32_t parts[3] = {0, 0, 0};
+    for (int i = 0; i < 3; i++) {
+        while (isdigit(*p)) {
+            parts[i] = parts[i] * 10 + *p++ - '0';
+        }
+        if (*p != ':' || i == 2) {
+            break;
+        }
+        p++;
+    }
+    seconds = sign * (parts[0] * 3600 + parts[1] * 60 + parts[2]);
+    return p;
+}
+
+// Mm.w.d[/time], the time defaults to 02:00
+const char *PosixTimeZone::parseTransition(const char *p, Transition &transition) {
+    int values[3];
+    if (*p++ != 'M') {
+        return nullptr;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (!isdigit(*p)) {
+            return nullptr;
+        }
+        values[i] = 0;
+        while (isdigit(*p)) {
+            values[i] = values[i] * 10 + *p++ - '0';
+        }
+        if (i < 2 && *p++ != '.') {
+            return nullptr;
+        }
+    }
+    if (values[0] < 1 || values[0] > 12 || values[1] < 1 || values[1] > 5 || values[2] > 6) {
+        return nullptr;
+    }
+    transition.month = values[0];
+    transition.week = values[1];
+    transition.weekday = values[2];
+    transition.time = 7200;
+    if (*p == '/') {
+        p = parseTime(p + 1, transition.time);
+    }
+    return p;
+}
+
+// The transition as seconds since the epoch on the local wall clock
+int64_t PosixTimeZone::transitionTime(int year, const Transition &transition) {
+    int64_t first = daysFromCivil(year, transition.month, 1);
+    // 1970-01-01 was a Thursday
+    int firstWeekday = (int)(((first + 4) % 7 + 7) % 7);
+    int day = 1 + (transition.weekday - firstWeekday + 7) % 7 + (transition.week - 1) * 7;
+    while (day > daysInMonth(year, transition.month)) {
+        day -= 7;
+    }
+    return (first + day - 1) * 86400 + transition.time;
+}
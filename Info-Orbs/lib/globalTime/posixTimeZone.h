@@ -0,0 +1,37 @@
+#ifndef POSIX_TIME_ZONE_H
+#define POSIX_TIME_ZONE_H
+
+#include <stdint.h>
+#include <time.h>
+
+// Evaluates a POSIX TZ rule such as "CET-1CEST,M3.5.0,M10.5.0/3" for any UTC
+// time without touching the process wide TZ, so several zones can be shown
+// at once. Only the Mm.w.d transition form is supported, which is what every
+// rule in timeZones.h uses.
+class PosixTimeZone {
+   public:
+    bool parse(const char *rule);
+    int32_t getOffset(time_t utc);
+    time_t toLocal(time_t utc);
+
+   private:
+    struct Transition {
+        uint8_t month;
+        uint8_t week;     // 5 is the last week of the month
+        uint8_t weekday;  // 0 is Sunday
+        int32_t time;     // local wall clock seconds after midnight, may be negative or past 24h
+    };
+
+    static const char *parseName(const char *p);
+    static const char *parseTime(const char *p, int32_t &seconds);
+    static const char *parseTransition(const char *p, Transition &transition);
+    static int64_t transitionTime(int year, const Transition &transition);
+
+    int32_t m_stdOffset = 0;  // seconds east of UTC
+    int32_t m_dstOffset = 0;
+    bool m_hasDst = false;
+    Transition m_start = {};
+    Transition m_end = {};
+};
+
+#endif
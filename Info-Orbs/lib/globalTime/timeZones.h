@@ -0,0 +1,107 @@
+#ifndef TIME_ZONES_H
+#define TIME_ZONES_H
+
+#include <lookupTable.h>
+
+// POSIX TZ rules for common IANA zones, newlib applies them with localtime_r so
+// DST starts and ends on time without asking a server. Zones missing here can
+// be given directly with TIMEZONE_POSIX in config.h.
+struct TimeZoneRule {
+    const char *location;
+    const char *posix;
+};
+
+static constexpr TimeZoneRule TIME_ZONES[] = {
+    {"UTC", "UTC0"},
+    {"Etc/UTC", "UTC0"},
+    {"America/Vancouver", "PST8PDT,M3.2.0,M11.1.0"},
+    {"America/Los_Angeles", "PST8PDT,M3.2.0,M11.1.0"},
+    {"America/Edmonton", "MST7MDT,M3.2.0,M11.1.0"},
+    {"America/Denver", "MST7MDT,M3.2.0,M11.1.0"},
+    {"America/Phoenix", "MST7"},
+    {"America/Winnipeg", "CST6CDT,M3.2.0,M11.1.0"},
+    {"America/Chicago", "CST6CDT,M3.2.0,M11.1.0"},
+    {"America/Regina", "CST6"},
+    {"America/Mexico_City", "CST6"},
+    {"America/Toronto", "EST5EDT,M3.2.0,M11.1.0"},
+    {"America/New_York", "EST5EDT,M3.2.0,M11.1.0"},
+    {"America/Detroit", "EST5EDT,M3.2.0,M11.1.0"},
+    {"America/Halifax", "AST4ADT,M3.2.0,M11.1.0"},
+    {"America/St_Johns", "NST3:30NDT,M3.2.0,M11.1.0"},
+    {"America/Anchorage", "AKST9AKDT,M3.2.0,M11.1.0"},
+    {"Pacific/Honolulu", "HST10"},
+    {"America/Bogota", "<-05>5"},
+    {"America/Lima", "<-05>5"},
+    {"America/Caracas", "<-04>4"},
+    {"America/Santiago", "<-04>4<-03>,M9.1.6/24,M4.1.6/24"},
+    {"America/Sao_Paulo", "<-03>3"},
+    {"America/Argentina/Buenos_Aires", "<-03>3"},
+    {"Atlantic/Reykjavik", "GMT0"},
+    {"Europe/London", "GMT0BST,M3.5.0/1,M10.5.0"},
+    {"Europe/Dublin", "IST-1GMT0,M10.5.0,M3.5.0/1"},
+    {"Europe/Lisbon", "WET0WEST,M3.5.0/1,M10.5.0"},
+    {"Europe/Paris", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Berlin", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Amsterdam", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Brussels", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Madrid", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Rome", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Vienna", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Zurich", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Stockholm", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Oslo", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Copenhagen", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Prague", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Warsaw", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Budapest", "CET-1CEST,M3.5.0,M10.5.0/3"},
+    {"Europe/Athens", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+    {"Europe/Helsinki", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+    {"Europe/Kyiv", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+    {"Europe/Kiev", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+    {"Europe/Bucharest", "EET-2EEST,M3.5.0/3,M10.5.0/4"},
+    {"Europe/Istanbul", "<+03>-3"},
+    {"Europe/Moscow", "MSK-3"},
+    {"Africa/Cairo", "EET-2EEST,M4.5.5/0,M10.5.4/24"},
+    {"Africa/Lagos", "WAT-1"},
+    {"Africa/Johannesburg", "SAST-2"},
+    {"Africa/Nairobi", "EAT-3"},
+    {"Asia/Jerusalem", "IST-2IDT,M3.4.4/26,M10.5.0"},
+    {"Asia/Tehran", "<+0330>-3:30"},
+    {"Asia/Dubai", "<+04>-4"},
+    {"Asia/Karachi", "PKT-5"},
+    {"Asia/Kolkata", "IST-5:30"},
+    {"Asia/Kathmandu", "<+0545>-5:45"},
+    {"Asia/Dhaka", "<+06>-6"},
+    {"Asia/Bangkok", "<+07>-7"},
+    {"Asia/Ho_Chi_Minh", "<+07>-7"},
+    {"Asia/Jakarta", "WIB-7"},
+    {"Asia/Singapore", "<+08>-8"},
+    {"Asia/Kuala_Lumpur", "<+08>-8"},
+    {"Asia/Shanghai", "CST-8"},
+    {"Asia/Hong_Kong", "HKT-8"},
+    {"Asia/Taipei", "CST-8"},
+    {"Asia/Manila", "PST-8"},
+    {"Asia/Seoul", "KST-9"},
+    {"Asia/Tokyo", "JST-9"},
+    {"Australia/Perth", "AWST-8"},
+    {"Australia/Darwin", "ACST-9:30"},
+    {"Australia/Adelaide", "ACST-9:30ACDT,M10.1.0,M4.1.0/3"},
+    {"Australia/Brisbane", "AEST-10"},
+    {"Australia/Sydney", "AEST-10AEDT,M10.1.0,M4.1.0/3"},
+    {"Australia/Melbourne", "AEST-10AEDT,M10.1.0,M4.1.0/3"},
+    {"Australia/Hobart", "AEST-10AEDT,M10.1.0,M4.1.0/3"},
+    {"Pacific/Auckland", "NZST-12NZDT,M9.5.0,M4.1.0/3"},
+};
+
+// Rule for an IANA location, nullptr when it isn't in the table. Only runs
+// once per location, usually at compile time, so a linear search is fine.
+constexpr const char *findTimeZone(const char *location) {
+    for (const TimeZoneRule &zone : TIME_ZONES) {
+        if (lookup::equals(location, zone.location)) {
+            return zone.posix;
+        }
+    }
+    return nullptr;
+}
+
+#endif
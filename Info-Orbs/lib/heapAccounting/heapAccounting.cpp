@@ -0,0 +1,186 @@
+#ifdef HEAP_ACCOUNTING
+
+#include "heapAccounting.h"
+
+#include <esp_heap_caps.h>
+
+#define HEAP_TAG_UNTAGGED 0
+#define HEAP_TAG_TASKS 1
+
+static portMUX_TYPE heapAccountingLock = portMUX_INITIALIZER_UNLOCKED;
+
+HeapAccounting::TagStats HeapAccounting::m_tags[HEAP_ACCOUNTING_MAX_TAGS] = {{"untagged"}, {"tasks"}};
+uint8_t HeapAccounting::m_tagCount = 2;
+uint8_t HeapAccounting::m_currentTag = HEAP_TAG_UNTAGGED;
+void *HeapAccounting::m_loopTask = nullptr;
+void *HeapAccounting::m_pointers[HEAP_ACCOUNTING_SLOTS];
+uint32_t HeapAccounting::m_sizes[HEAP_ACCOUNTING_SLOTS];
+uint8_t HeapAccounting::m_pointerTags[HEAP_ACCOUNTING_SLOTS];
+uint32_t HeapAccounting::m_untracked = 0;
+uint32_t HeapAccounting::m_allocationCount = 0;
+uint32_t HeapAccounting::m_minLargestBlock = UINT32_MAX;
+unsigned long HeapAccounting::m_lastReport = 0;
+
+extern "C" {
+void *__real_malloc(size_t size);
+void __real_free(void *ptr);
+void *__real_realloc(void *ptr, size_t size);
+void *__real_calloc(size_t count, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    void *ptr = __real_malloc(size);
+    HeapAccounting::record(ptr, size);
+    return ptr;
+}
+
+void __wrap_free(void *ptr) {
+    HeapAccounting::forget(ptr);
+    __real_free(ptr);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    void *result = __real_realloc(ptr, size);
+    // a failed realloc leaves the old block alone
+    if (result != nullptr || size == 0) {
+        HeapAccounting::forget(ptr);
+        HeapAccounting::record(result, size);
+    }
+    return result;
+}
+
+void *__wrap_calloc(size_t count, size_t size) {
+    void *ptr = __real_calloc(count, size);
+    HeapAccounting::record(ptr, count * size);
+    return ptr;
+}
+}
+
+// Allocations on the task that calls this follow the tag guards
+void HeapAccounting::begin() {
+    m_loopTask = xTaskGetCurrentTaskHandle();
+    m_lastReport = millis();
+}
+
+void HeapAccounting::update() {
+    uint32_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    m_minLargestBlock = min(m_minLargestBlock, largest);
+    if (millis() - m_lastReport >= HEAP_ACCOUNTING_REPORT_INTERVAL) {
+        m_lastReport = millis();
+        printReport();
+    }
+}
+
+// Only called from the loop task, so the names need no locking
+uint8_t HeapAccounting::getTag(const char *name) {
+    for (uint8_t i = 0; i < m_tagCount; i++) {
+        if (m_tags[i].name == name || strcmp(m_tags[i].name, name) == 0) {
+            return i;
+        }
+    }
+    if (m_tagCount == HEAP_ACCOUNTING_MAX_TAGS) {
+        return HEAP_TAG_UNTAGGED;
+    }
+    m_tags[m_tagCount].name = name;
+    return m_tagCount++;
+}
+
+uint8_t HeapAccounting::setTag(uint8_t tag) {
+    uint8_t previous = m_currentTag;
+    m_currentTag = tag;
+    return previous;
+}
+
+uint32_t HeapAccounting::getAllocationCount() {
+    return m_allocationCount;
+}
+
+void HeapAccounting::printAllocations(const char *work, uint32_t since) {
+    Serial.printf("%s: %u allocations\n", work, m_allocationCount - since);
+}
+
+void HeapAccounting::printReport() {
+    HeapTagGuard guard("heap report");
+    TagStats tags[HEAP_ACCOUNTING_MAX_TAGS];
+    portENTER_CRITICAL(&heapAccountingLock);
+    uint8_t count = m_tagCount;
+    memcpy(tags, m_tags, sizeof(tags));
+    for (uint8_t i = 0; i < count; i++) {
+        m_tags[i].allocations = 0;
+    }
+    uint32_t untracked = m_untracked;
+    portEXIT_CRITICAL(&heapAccountingLock);
+
+    Serial.printf("Heap: %u free, largest block %u, smallest largest block %u, %u untracked\n", ESP.getFreeHeap(), heap_caps_get_largest_free_block(MALLOC_CAP_8BIT), m_minLargestBlock, untracked);
+    Serial.println("Heap tag            live     peak   blocks   allocs");
+    for (uint8_t i = 0; i < count; i++) {
+        Serial.printf("%-16s %8u %8u %8u %8u\n", tags[i].name, tags[i].liveBytes, tags[i].peakBytes, tags[i].liveBlocks, tags[i].allocations);
+    }
+}
+
+uint32_t HeapAccounting::slot(void *ptr) {
+    // blocks are at least 4 byte aligned
+    uint32_t hash = ((uintptr_t)ptr >> 2) * 2654435761u;
+    return hash & (HEAP_ACCOUNTING_SLOTS - 1);
+}
+
+void HeapAccounting::record(void *ptr, size_t size) {
+    if (ptr == nullptr) {
+        return;
+    }
+    uint8_t tag = xTaskGetCurrentTaskHandle() == m_loopTask ? m_currentTag : HEAP_TAG_TASKS;
+    portENTER_CRITICAL(&heapAccountingLock);
+    m_allocationCount++;
+    uint32_t index = slot(ptr);
+    for (uint32_t probe = 0; probe < HEAP_ACCOUNTING_SLOTS; probe++) {
+        if (m_pointers[index] == nullptr) {
+            m_pointers[index] = ptr;
+            m_sizes[index] = size;
+            m_pointerTags[index] = tag;
+            TagStats &stats = m_tags[tag];
+            stats.liveBytes += size;
+            stats.liveBlocks++;
+            stats.allocations++;
+            stats.peakBytes = max(stats.peakBytes, stats.liveBytes);
+            portEXIT_CRITICAL(&heapAccountingLock);
+            return;
+        }
+        index = (index + 1) & (HEAP_ACCOUNTING_SLOTS - 1);
+    }
+    m_untracked++;
+    portEXIT_CRITICAL(&heapAccountingLock);
+}
+
+// Linear probing with backward shift, so lookups never need tombstones
+void HeapAccounting::forget(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    portENTER_CRITICAL(&heapAccountingLock);
+    uint32_t index = slot(ptr);
+    for (uint32_t probe = 0; probe < HEAP_ACCOUNTING_SLOTS && m_pointers[index] != nullptr; probe++) {
+        if (m_pointers[index] == ptr) {
+            TagStats &stats = m_tags[m_pointerTags[index]];
+            stats.liveBytes -= m_sizes[index];
+            stats.liveBlocks--;
+            uint32_t hole = index;
+            uint32_t next = (hole + 1) & (HEAP_ACCOUNTING_SLOTS - 1);
+            while (m_pointers[next] != nullptr) {
+                uint32_t home = slot(m_pointers[next]);
+                // move the entry back if the hole lies between its home slot and where it sits
+                if (((next - home) & (HEAP_ACCOUNTING_SLOTS - 1)) >= ((next - hole) & (HEAP_ACCOUNTING_SLOTS - 1))) {
+                    m_pointers[hole] = m_pointers[next];
+                    m_sizes[hole] = m_sizes[next];
+                    m_pointerTags[hole] = m_pointerTags[next];
+                    hole = next;
+                }
+                next = (next + 1) & (HEAP_ACCOUNTING_SLOTS - 1);
+            }
+            m_pointers[hole] = nullptr;
+            break;
+        }
+        index = (index + 1) & (HEAP_ACCOUNTING_SLOTS - 1);
+    }
+    portEXIT_CRITICAL(&heapAccountingLock);
+}
+
+#endif
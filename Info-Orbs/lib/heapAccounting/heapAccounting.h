@@ -0,0 +1,84 @@
+#ifndef HEAP_ACCOUNTING_H
+#define HEAP_ACCOUNTING_H
+
+#include <Arduino.h>
+
+#define HEAP_ACCOUNTING_MAX_TAGS 16
+#define HEAP_ACCOUNTING_SLOTS 4096              // live allocations that can be tracked, power of two
+#define HEAP_ACCOUNTING_REPORT_INTERVAL 60000   // how often the tag table is dumped (ms)
+
+// Optional allocator accounting, built with the heap-accounting environment
+// which defines HEAP_ACCOUNTING and links with --wrap for malloc, free,
+// realloc and calloc. Every allocation made on the loop task is charged to
+// the innermost HeapTagGuard, allocations from other tasks go to "tasks".
+// Memory IDF components take with heap_caps_malloc directly isn't seen.
+// Without HEAP_ACCOUNTING all of this compiles away.
+class HeapAccounting {
+   public:
+#ifdef HEAP_ACCOUNTING
+    static void begin();
+    static void update();
+    static void printReport();
+    // Allocations made by any task since boot, for counting what a piece of work costs
+    static uint32_t getAllocationCount();
+    static void printAllocations(const char *work, uint32_t since);
+
+    static uint8_t getTag(const char *name);
+    static uint8_t setTag(uint8_t tag);
+
+    static void record(void *ptr, size_t size);
+    static void forget(void *ptr);
+
+   private:
+    struct TagStats {
+        const char *name;
+        uint32_t liveBytes;
+        uint32_t peakBytes;
+        uint32_t liveBlocks;
+        uint32_t allocations;      // since the last report
+    };
+
+    static uint32_t slot(void *ptr);
+
+    static TagStats m_tags[HEAP_ACCOUNTING_MAX_TAGS];
+    static uint8_t m_tagCount;
+    static uint8_t m_currentTag;
+    static void *m_loopTask;
+
+    // open addressing table from live pointer to its size and tag
+    static void *m_pointers[HEAP_ACCOUNTING_SLOTS];
+    static uint32_t m_sizes[HEAP_ACCOUNTING_SLOTS];
+    static uint8_t m_pointerTags[HEAP_ACCOUNTING_SLOTS];
+    static uint32_t m_untracked;
+    static uint32_t m_allocationCount;
+
+    static uint32_t m_minLargestBlock;
+    static unsigned long m_lastReport;
+#else
+    static void begin() {}
+    static void update() {}
+    static void printReport() {}
+    static uint32_t getAllocationCount() { return 0; }
+    static void printAllocations(const char *work, uint32_t since) {}
+#endif
+};
+
+// Charges allocations in its scope to a subsystem, restores the outer tag when it goes
+class HeapTagGuard {
+   public:
+#ifdef HEAP_ACCOUNTING
+    explicit HeapTagGuard(const char *name) {
+        m_previous = HeapAccounting::setTag(HeapAccounting::getTag(name));
+    }
+    ~HeapTagGuard() {
+        HeapAccounting::setTag(m_previous);
+    }
+
+   private:
+    uint8_t m_previous;
+#else
+    explicit HeapTagGuard(const char *name) {}
+#endif
+};
+
+#endif
@@ -0,0 +1,65 @@
+#include "histogram.h"
+
+Histogram::Histogram(const char *name, const char *unit, const uint32_t *bounds, uint8_t boundCount) : m_name(name), m_unit(unit), m_bounds(bounds), m_boundCount(min(boundCount, (uint8_t)HISTOGRAM_MAX_BUCKETS)) {
+}
+
+void Histogram::add(uint32_t value) {
+    uint8_t bucket = 0;
+    while (bucket < m_boundCount && value >= m_bounds[bucket]) {
+        bucket++;
+    }
+    m_counts[bucket]++;
+    m_count++;
+    m_sum += value;
+    m_max = max(m_max, value);
+}
+
+// One line, empty buckets are left out
+void Histogram::print() {
+    if (m_count == 0) {
+        Serial.printf("%s: no samples\n", m_name);
+        return;
+    }
+    Serial.printf("%s: %u samples, mean %u %s, max %u %s |", m_name, m_count, (uint32_t)(m_sum / m_count), m_unit, m_max, m_unit);
+    for (uint8_t i = 0; i <= m_boundCount; i++) {
+        if (m_counts[i] == 0) {
+            continue;
+        }
+        if (i < m_boundCount) {
+            Serial.printf(" <%u: %u", m_bounds[i], m_counts[i]);
+        } else {
+            Serial.printf(" >=%u: %u", m_bounds[m_boundCount - 1], m_counts[i]);
+        }
+    }
+    Serial.println();
+}
+
+void Histogram::reset() {
+    memset(m_counts, 0, sizeof(m_counts));
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+}
+
+uint32_t Histogram::getCount() {
+    return m_count;
+}
+
+void Histogram::save(Preferences &preferences, const char *key) {
+    Saved saved = {m_boundCount, {}, m_count, m_sum, m_max};
+    memcpy(saved.counts, m_counts, sizeof(saved.counts));
+    preferences.putBytes(key, &saved, sizeof(saved));
+}
+
+// Samples saved with different buckets are dropped rather than misfiled
+void Histogram::load(Preferences &preferences, const char *key) {
+    Saved saved;
+    if (preferences.getBytesLength(key) != sizeof(saved) || preferences.getBytes(key, &saved, sizeof(saved)) != sizeof(saved) ||
+        saved.boundCount != m_boundCount) {
+        return;
+    }
+    memcpy(m_counts, saved.counts, sizeof(m_counts));
+    m_count = saved.count;
+    m_sum = saved.sum;
+    m_max = saved.max;
+}
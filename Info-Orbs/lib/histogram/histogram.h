@@ -0,0 +1,43 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+#define HISTOGRAM_MAX_BUCKETS 12
+
+// Counts samples into fixed buckets for reporting over serial. Bounds are the
+// ascending exclusive upper limits of each bucket, samples at or above the
+// last bound land in an overflow bucket.
+class Histogram {
+   public:
+    Histogram(const char *name, const char *unit, const uint32_t *bounds, uint8_t boundCount);
+
+    void add(uint32_t value);
+    void print();
+    void reset();
+    uint32_t getCount();
+    // Keeps the samples across reboots under key in an open NVS namespace
+    void save(Preferences &preferences, const char *key);
+    void load(Preferences &preferences, const char *key);
+
+   private:
+    struct Saved {
+        uint8_t boundCount;
+        uint32_t counts[HISTOGRAM_MAX_BUCKETS + 1];
+        uint32_t count;
+        uint64_t sum;
+        uint32_t max;
+    };
+
+    const char *m_name;
+    const char *m_unit;
+    const uint32_t *m_bounds;
+    uint8_t m_boundCount;
+    uint32_t m_counts[HISTOGRAM_MAX_BUCKETS + 1] = {};
+    uint32_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint32_t m_max = 0;
+};
+
+#endif
@@ -0,0 +1,455 @@
+#include "imageCache.h"
+
+#include <HTTPClient.h>
+#include <LittleFS.h>
+#include <TJpg_Decoder.h>
+#include <fetchPolicy.h>
+#include <heapAccounting.h>
+
+#define IMAGE_CACHE_TEMP IMAGE_CACHE_DIR "/tmp"
+#define IMAGE_CACHE_INDEX IMAGE_CACHE_DIR "/index"
+#define IMAGE_CACHE_INDEX_VERSION 0x31434d49  // "IMC1", bump when Entry changes
+
+ImageCache *ImageCache::m_instance = nullptr;
+
+ImageCache::ImageCache() {
+}
+
+ImageCache *ImageCache::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new ImageCache();
+    }
+    return m_instance;
+}
+
+// Queues url for download unless a fresh copy is cached. Raw images pass their
+// expected size, anything else has to be a JPEG. Never blocks, update() runs
+// the download and bumps the generation once the image is there.
+void ImageCache::request(const String &url, uint32_t expectedSize) {
+    if (!begin() || !needsFetch(hash(url))) {
+        return;
+    }
+    for (int i = 0; i < m_pendingCount; i++) {
+        if (m_pending[i].url == url) {
+            return;
+        }
+    }
+    if (m_pendingCount < IMAGE_CACHE_MAX_PENDING) {
+        m_pending[m_pendingCount].url = url;
+        m_pending[m_pendingCount].expectedSize = expectedSize;
+        m_pendingCount++;
+    }
+}
+
+// Starts the oldest queued download or carries on with the running one,
+// called from the loop
+void ImageCache::update() {
+    if (m_downloading) {
+        continueDownload();
+        return;
+    }
+    if (m_pendingCount == 0) {
+        return;
+    }
+    Request request = m_pending[0];
+    for (int i = 1; i < m_pendingCount; i++) {
+        m_pending[i - 1] = m_pending[i];
+    }
+    m_pending[--m_pendingCount].url = "";
+    uint32_t urlKey = hash(request.url);
+    if (!needsFetch(urlKey) || !FetchPolicy::getInstance()->allowRequest(request.url)) {
+        return;
+    }
+    if (!startDownload(request, urlKey)) {
+        rememberFailure(urlKey);
+    }
+}
+
+// Returns the cached file for url and the size of a JPEG without going to the network
+String ImageCache::lookup(const String &url, uint16_t *width, uint16_t *height) {
+    if (!begin()) {
+        return "";
+    }
+    Entry *entry = find(hash(url));
+    if (entry == nullptr) {
+        return "";
+    }
+    entry->lastUsed = ++m_clock;
+    if (width != nullptr && height != nullptr) {
+        *width = entry->width;
+        *height = entry->height;
+    }
+    char path[16];
+    getPath(entry->contentKey, path, sizeof(path));
+    return path;
+}
+
+// Changes whenever an image was added or replaced, users look their images up again
+uint32_t ImageCache::getGeneration() {
+    return m_generation;
+}
+
+void ImageCache::printStatus() {
+    Serial.printf("Image cache: %d entries, %u of %u bytes, %d queued\n", m_count, m_used, IMAGE_CACHE_BUDGET, m_pendingCount);
+}
+
+// Mounts LittleFS, loads the index and removes files it doesn't reference
+bool ImageCache::begin() {
+    if (m_mounted || m_mountFailed) {
+        return m_mounted;
+    }
+    if (!LittleFS.begin(true)) {
+        Serial.println("Image cache: LittleFS mount failed, images disabled");
+        m_mountFailed = true;
+        return false;
+    }
+    m_mounted = true;
+    LittleFS.remove(IMAGE_CACHE_TEMP);
+    File dir = LittleFS.open(IMAGE_CACHE_DIR);
+    if (!dir || !dir.isDirectory()) {
+        LittleFS.mkdir(IMAGE_CACHE_DIR);
+        return true;
+    }
+    loadIndex();
+    File file = dir.openNextFile();
+    while (file) {
+        String path = String(IMAGE_CACHE_DIR "/") + file.name();
+        file.close();
+        bool referenced = path == IMAGE_CACHE_INDEX;
+        for (int i = 0; i < m_count && !referenced; i++) {
+            char entryPath[16];
+            getPath(m_entries[i].contentKey, entryPath, sizeof(entryPath));
+            referenced = path == entryPath;
+        }
+        if (!referenced) {
+            LittleFS.remove(path);
+        }
+        file = dir.openNextFile();
+    }
+    printStatus();
+    return true;
+}
+
+ImageCache::Entry *ImageCache::find(uint32_t urlKey) {
+    for (int i = 0; i < m_count; i++) {
+        if (m_entries[i].urlKey == urlKey) {
+            return &m_entries[i];
+        }
+    }
+    return nullptr;
+}
+
+bool ImageCache::isShared(uint32_t contentKey) {
+    for (int i = 0; i < m_count; i++) {
+        if (m_entries[i].contentKey == contentKey) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Missing images are fetched, cached ones once per boot and then every IMAGE_CACHE_REVALIDATE
+bool ImageCache::needsFetch(uint32_t urlKey) {
+    Entry *entry = find(urlKey);
+    if (entry != nullptr && entry->validated && millis() - entry->validatedAt < IMAGE_CACHE_REVALIDATE) {
+        return false;
+    }
+    return !isBackingOff(urlKey);
+}
+
+// Evicts least recently used entries until size more bytes and one more entry fit
+bool ImageCache::makeRoom(uint32_t size) {
+    if (size > IMAGE_CACHE_BUDGET) {
+        return false;
+    }
+    while (m_count > 0 && (m_count == IMAGE_CACHE_MAX_ENTRIES || m_used + size > IMAGE_CACHE_BUDGET)) {
+        Entry *oldest = &m_entries[0];
+        for (int i = 1; i < m_count; i++) {
+            if (m_entries[i].lastUsed < oldest->lastUsed) {
+                oldest = &m_entries[i];
+            }
+        }
+        evict(oldest);
+    }
+    return true;
+}
+
+// Drops the entry, its file goes with the last entry that refers to it
+void ImageCache::evict(Entry *entry) {
+    uint32_t contentKey = entry->contentKey;
+    uint32_t size = entry->size;
+    *entry = m_entries[--m_count];
+    if (!isShared(contentKey)) {
+        char path[16];
+        getPath(contentKey, path, sizeof(path));
+        Serial.printf("Image cache: evicting %s (%u bytes)\n", path, size);
+        LittleFS.remove(path);
+        m_used -= size;
+    }
+}
+
+// Sends the request and opens the temporary file the body goes into, the
+// body itself is read by continueDownload() over the following updates. A
+// cached image is revalidated with its ETag, 304 keeps the file as it is.
+bool ImageCache::startDownload(const Request &request, uint32_t urlKey) {
+    HeapTagGuard tag("images");
+    Entry *entry = find(urlKey);
+    m_http.begin(request.url);
+    // HTTP/1.0 keeps chunk framing out of the file
+    m_http.useHTTP10(true);
+    if (entry != nullptr && entry->etag[0] != '\0') {
+        m_http.addHeader("If-None-Match", entry->etag);
+    }
+    const char *headerKeys[] = {"ETag"};
+    m_http.collectHeaders(headerKeys, 1);
+    int httpCode = m_http.GET();
+    FetchPolicy::getInstance()->reportResult(request.url, httpCode);
+    if (httpCode == HTTP_CODE_NOT_MODIFIED && entry != nullptr) {
+        m_http.end();
+        entry->validated = true;
+        entry->validatedAt = millis();
+        return true;
+    }
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("Image download failed (%d): %s\n", httpCode, request.url.c_str());
+        m_http.end();
+        return false;
+    }
+    int length = m_http.getSize();
+    if (length > IMAGE_CACHE_MAX_IMAGE) {
+        Serial.printf("Image too large (%d bytes): %s\n", length, request.url.c_str());
+        m_http.end();
+        return false;
+    }
+    m_file = LittleFS.open(IMAGE_CACHE_TEMP, "w");
+    if (!m_file) {
+        m_http.end();
+        return false;
+    }
+    m_download.request = request;
+    m_download.urlKey = urlKey;
+    m_download.etag = m_http.header("ETag");
+    m_download.length = length;
+    m_download.total = 0;
+    m_download.contentHash = 2166136261u;
+    m_download.magic[0] = 0;
+    m_download.magic[1] = 0;
+    m_download.lastData = millis();
+    m_downloading = true;
+    return true;
+}
+
+// Writes what has arrived to the file without waiting for more, at most
+// IMAGE_CACHE_READ_BUDGET bytes per call so a fast server doesn't hold up the
+// loop either. Finishes the download once the body is complete or stalled.
+void ImageCache::continueDownload() {
+    HeapTagGuard tag("images");
+    Download &download = m_download;
+    WiFiClient &stream = m_http.getStream();
+    uint8_t buf[512];
+    uint32_t budget = IMAGE_CACHE_READ_BUDGET;
+    bool ok = true;
+    while (budget > 0 && (download.length < 0 || download.total < (uint32_t)download.length)) {
+        int available = stream.available();
+        if (available <= 0) {
+            break;
+        }
+        int len = stream.read(buf, min((uint32_t)min(available, (int)sizeof(buf)), budget));
+        if (len <= 0) {
+            break;
+        }
+        if (download.total == 0 && len >= 2) {
+            download.magic[0] = buf[0];
+            download.magic[1] = buf[1];
+        }
+        if (download.total + len > IMAGE_CACHE_MAX_IMAGE || m_file.write(buf, len) != (size_t)len) {
+            ok = false;
+            break;
+        }
+        download.contentHash = hash(buf, len, download.contentHash);
+        download.total += len;
+        download.lastData = millis();
+        budget -= len;
+    }
+    bool complete = download.length >= 0 && download.total >= (uint32_t)download.length;
+    bool closed = !m_http.connected() && stream.available() <= 0;
+    if (ok && !complete && !closed) {
+        if (millis() - download.lastData <= IMAGE_CACHE_TIMEOUT) {
+            // more to come on a later update
+            return;
+        }
+        Serial.printf("Image download stalled: %s\n", download.request.url.c_str());
+        ok = false;
+    }
+    m_file.close();
+    m_http.end();
+    m_downloading = false;
+    if (!finishDownload(ok)) {
+        rememberFailure(download.urlKey);
+    }
+}
+
+// Moves the temporary file to its content address once the image arrived
+// complete and looks like what the element expects
+bool ImageCache::finishDownload(bool ok) {
+    HeapTagGuard tag("images");
+    const Request &request = m_download.request;
+    uint32_t urlKey = m_download.urlKey;
+    uint32_t total = m_download.total;
+    int length = m_download.length;
+    String &etag = m_download.etag;
+    Entry *entry = find(urlKey);
+    if (ok && length > 0 && total != (uint32_t)length) {
+        ok = false;
+    }
+    bool valid = request.expectedSize > 0 ? total == request.expectedSize : m_download.magic[0] == 0xFF && m_download.magic[1] == 0xD8;
+    if (ok && !valid) {
+        Serial.printf("Image rejected, %u bytes not a %s: %s\n", total, request.expectedSize > 0 ? "raw image of the given size" : "JPEG", request.url.c_str());
+        ok = false;
+    }
+    // an ETag too long to store could not be sent back, treat it as absent
+    if (etag.length() >= IMAGE_CACHE_ETAG_LENGTH) {
+        etag = "";
+    }
+    uint32_t contentKey = etag != "" ? hash(etag, urlKey) : m_download.contentHash;
+    if (ok && entry != nullptr) {
+        if (entry->contentKey == contentKey) {
+            // same bytes as before, e.g. a server without ETags
+            LittleFS.remove(IMAGE_CACHE_TEMP);
+            entry->validated = true;
+            entry->validatedAt = millis();
+            return true;
+        }
+        // the image changed, its old version goes like an evicted one
+        evict(entry);
+    }
+    if (!ok || !makeRoom(total)) {
+        LittleFS.remove(IMAGE_CACHE_TEMP);
+        return false;
+    }
+    char path[16];
+    getPath(contentKey, path, sizeof(path));
+    if (isShared(contentKey)) {
+        // another URL serves the same bytes
+        LittleFS.remove(IMAGE_CACHE_TEMP);
+    } else if (LittleFS.rename(IMAGE_CACHE_TEMP, path)) {
+        m_used += total;
+    } else {
+        LittleFS.remove(IMAGE_CACHE_TEMP);
+        return false;
+    }
+    Entry &added = m_entries[m_count++];
+    added.urlKey = urlKey;
+    added.contentKey = contentKey;
+    added.size = total;
+    added.lastUsed = ++m_clock;
+    added.width = 0;
+    added.height = 0;
+    if (request.expectedSize == 0) {
+        // measured once here so drawing never has to open the file for it
+        TJpgDec.getFsJpgSize(&added.width, &added.height, path, LittleFS);
+    }
+    strlcpy(added.etag, etag.c_str(), sizeof(added.etag));
+    added.validated = true;
+    added.validatedAt = millis();
+    saveIndex();
+    m_generation++;
+    Serial.printf("Image cached as %s (%u bytes): %s\n", path, total, request.url.c_str());
+    return true;
+}
+
+// The index keeps URLs, ETags and sizes across reboots, files it doesn't list are removed
+void ImageCache::loadIndex() {
+    File file = LittleFS.open(IMAGE_CACHE_INDEX, "r");
+    if (!file) {
+        return;
+    }
+    uint32_t header[2] = {0, 0};
+    if (file.read((uint8_t *)header, sizeof(header)) != sizeof(header) || header[0] != IMAGE_CACHE_INDEX_VERSION) {
+        file.close();
+        return;
+    }
+    Entry entry;
+    for (uint32_t i = 0; i < header[1] && m_count < IMAGE_CACHE_MAX_ENTRIES; i++) {
+        if (file.read((uint8_t *)&entry, sizeof(entry)) != sizeof(entry)) {
+            break;
+        }
+        char path[16];
+        getPath(entry.contentKey, path, sizeof(path));
+        if (!isShared(entry.contentKey)) {
+            File image = LittleFS.open(path, "r");
+            bool intact = image && image.size() == entry.size;
+            image.close();
+            if (!intact || m_used + entry.size > IMAGE_CACHE_BUDGET) {
+                continue;
+            }
+            m_used += entry.size;
+        }
+        entry.etag[IMAGE_CACHE_ETAG_LENGTH - 1] = '\0';
+        entry.validated = false;
+        m_clock = max(m_clock, entry.lastUsed);
+        m_entries[m_count++] = entry;
+    }
+    file.close();
+}
+
+void ImageCache::saveIndex() {
+    File file = LittleFS.open(IMAGE_CACHE_INDEX, "w");
+    if (!file) {
+        return;
+    }
+    uint32_t header[2] = {IMAGE_CACHE_INDEX_VERSION, (uint32_t)m_count};
+    file.write((const uint8_t *)header, sizeof(header));
+    file.write((const uint8_t *)m_entries, sizeof(Entry) * m_count);
+    file.close();
+}
+
+bool ImageCache::isBackingOff(uint32_t key) {
+    for (int i = 0; i < m_failureCount; i++) {
+        if (m_failures[i].key == key) {
+            return (long)(millis() - m_failures[i].retryAt) < 0;
+        }
+    }
+    return false;
+}
+
+// Keeps a URL that failed from being fetched again on every parse
+void ImageCache::rememberFailure(uint32_t key) {
+    int slot = -1;
+    for (int i = 0; i < m_failureCount && slot == -1; i++) {
+        if (m_failures[i].key == key) {
+            slot = i;
+        }
+    }
+    if (slot == -1 && m_failureCount < IMAGE_CACHE_MAX_FAILURES) {
+        slot = m_failureCount++;
+    }
+    if (slot == -1) {
+        // full, replace the one that is due first
+        slot = 0;
+        for (int i = 1; i < m_failureCount; i++) {
+            if ((long)(m_failures[i].retryAt - m_failures[slot].retryAt) < 0) {
+                slot = i;
+            }
+        }
+    }
+    m_failures[slot].key = key;
+    m_failures[slot].retryAt = millis() + IMAGE_CACHE_RETRY_DELAY;
+}
+
+// FNV-1a
+uint32_t ImageCache::hash(const uint8_t *data, size_t length, uint32_t seed) {
+    uint32_t hash = seed;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash;
+}
+
+uint32_t ImageCache::hash(const String &text, uint32_t seed) {
+    return hash((const uint8_t *)text.c_str(), text.length(), seed);
+}
+
+void ImageCache::getPath(uint32_t contentKey, char *path, size_t size) {
+    snprintf(path, size, IMAGE_CACHE_DIR "/%08x", contentKey);
+}
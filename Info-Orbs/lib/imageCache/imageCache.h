@@ -0,0 +1,113 @@
+#ifndef IMAGE_CACHE_H
+#define IMAGE_CACHE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include <HTTPClient.h>
+
+#define IMAGE_CACHE_DIR "/img"
+#define IMAGE_CACHE_BUDGET 262144       // bytes of LittleFS the cache may fill
+#define IMAGE_CACHE_MAX_ENTRIES 32
+#define IMAGE_CACHE_MAX_IMAGE 65536     // larger downloads are refused
+#define IMAGE_CACHE_TIMEOUT 10000       // give up on a download that stalls this long (ms)
+#define IMAGE_CACHE_READ_BUDGET 4096    // bytes of a download written per update()
+#define IMAGE_CACHE_RETRY_DELAY 300000  // wait before retrying a URL that failed (ms)
+#define IMAGE_CACHE_MAX_FAILURES 8
+#define IMAGE_CACHE_REVALIDATE 3600000  // ask the server whether a cached image changed this often (ms)
+#define IMAGE_CACHE_MAX_PENDING 4       // queued downloads, further requests are retried on the next parse
+#define IMAGE_CACHE_ETAG_LENGTH 48
+
+// Downloads images into LittleFS and hands out their paths. Files are content
+// addressed: named after a hash of the URL and ETag, or of the bytes when the
+// server sends no ETag, so URLs serving the same bytes share one file. The
+// index of URLs, ETags and JPEG sizes is kept in a file next to the images.
+// Lookups never touch the network. Downloads are queued by request() and run
+// one at a time from the loop, each update() only reads what has arrived so
+// far. Cached images are revalidated with
+// If-None-Match every IMAGE_CACHE_REVALIDATE. Least recently used entries are
+// evicted to stay within IMAGE_CACHE_BUDGET.
+class ImageCache {
+   public:
+    static ImageCache *getInstance();
+
+    bool begin();
+    void request(const String &url, uint32_t expectedSize = 0);
+    void update();
+    String lookup(const String &url, uint16_t *width = nullptr, uint16_t *height = nullptr);
+    uint32_t getGeneration();
+
+    void printStatus();
+
+   private:
+    struct Entry {
+        uint32_t urlKey;
+        uint32_t contentKey;
+        uint32_t size;
+        uint32_t lastUsed;
+        uint16_t width;  // of a JPEG, 0 for raw images
+        uint16_t height;
+        char etag[IMAGE_CACHE_ETAG_LENGTH];
+        unsigned long validatedAt;
+        bool validated;  // since boot, entries from the index are revalidated on first request
+    };
+
+    struct Failure {
+        uint32_t key;
+        unsigned long retryAt;
+    };
+
+    struct Request {
+        String url;
+        uint32_t expectedSize;
+    };
+
+    // The running download, kept between update() calls
+    struct Download {
+        Request request;
+        uint32_t urlKey;
+        String etag;
+        int length;  // Content-Length, -1 when the server sent none
+        uint32_t total;
+        uint32_t contentHash;
+        uint8_t magic[2];
+        unsigned long lastData;
+    };
+
+    ImageCache();
+
+    Entry *find(uint32_t urlKey);
+    bool isShared(uint32_t contentKey);
+    bool needsFetch(uint32_t urlKey);
+    bool makeRoom(uint32_t size);
+    void evict(Entry *entry);
+    bool startDownload(const Request &request, uint32_t urlKey);
+    void continueDownload();
+    bool finishDownload(bool ok);
+    void loadIndex();
+    void saveIndex();
+    bool isBackingOff(uint32_t key);
+    void rememberFailure(uint32_t key);
+    static void getPath(uint32_t contentKey, char *path, size_t size);
+    static uint32_t hash(const uint8_t *data, size_t length, uint32_t seed = 2166136261u);
+    static uint32_t hash(const String &text, uint32_t seed = 2166136261u);
+
+    static ImageCache *m_instance;
+
+    bool m_mounted = false;
+    bool m_mountFailed = false;
+    Entry m_entries[IMAGE_CACHE_MAX_ENTRIES];
+    int m_count = 0;
+    uint32_t m_used = 0;
+    uint32_t m_clock = 0;
+    uint32_t m_generation = 0;
+    Failure m_failures[IMAGE_CACHE_MAX_FAILURES];
+    int m_failureCount = 0;
+    Request m_pending[IMAGE_CACHE_MAX_PENDING];
+    int m_pendingCount = 0;
+    bool m_downloading = false;
+    Download m_download;
+    HTTPClient m_http;
+    File m_file;
+};
+
+#endif
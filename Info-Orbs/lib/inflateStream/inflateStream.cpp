@@ -0,0 +1,249 @@
+#include "inflateStream.h"
+
+#include <memoryGovernor.h>
+
+#define GZIP_FHCRC 0x02
+#define GZIP_FEXTRA 0x04
+#define GZIP_FNAME 0x08
+#define GZIP_FCOMMENT 0x10
+
+InflateStream::InflateStream(Stream &source, const String &contentEncoding) : m_source(source) {
+    if (contentEncoding.indexOf("gzip") != -1) {
+        m_encoding = GZIP;
+    } else if (contentEncoding.indexOf("deflate") != -1) {
+        m_encoding = DEFLATE;
+    }
+}
+
+InflateStream::~InflateStream() {
+    free(m_decompressor);
+    free(m_window);
+}
+
+// Asks for a compressed body and collects the response headers the fetch path uses.
+// HTTP/1.0 keeps chunk framing out of the body so it can be read straight off the socket.
+void InflateStream::prepare(HTTPClient &http) {
+    http.useHTTP10(true);
+    http.addHeader("Accept-Encoding", "gzip, deflate");
+    const char *headerKeys[] = {"Content-Encoding", "Content-Type", "Cache-Control"};
+    http.collectHeaders(headerKeys, 3);
+}
+
+int InflateStream::available() {
+    if (m_encoding == IDENTITY) {
+        return m_source.available();
+    }
+    if (m_readPos < m_readEnd) {
+        return m_readEnd - m_readPos;
+    }
+    return m_done || m_error ? 0 : 1;
+}
+
+int InflateStream::read() {
+    if (m_encoding == IDENTITY) {
+        int c = m_source.read();
+        if (c >= 0) {
+            m_wireBytes++;
+            m_decodedBytes++;
+        }
+        return c;
+    }
+    if (m_readPos == m_readEnd && !fill()) {
+        return -1;
+    }
+    return m_window[m_readPos++];
+}
+
+int InflateStream::peek() {
+    if (m_encoding == IDENTITY) {
+        return m_source.peek();
+    }
+    if (m_readPos == m_readEnd && !fill()) {
+        return -1;
+    }
+    return m_window[m_readPos];
+}
+
+size_t InflateStream::write(uint8_t) {
+    return 0;
+}
+
+bool InflateStream::hasError() {
+    return m_error;
+}
+
+size_t InflateStream::getWireBytes() {
+    return m_wireBytes;
+}
+
+size_t InflateStream::getDecodedBytes() {
+    return m_decodedBytes;
+}
+
+void InflateStream::printStats(const char *endpoint) {
+    const char *encoding = m_encoding == GZIP ? "gzip" : m_encoding == DEFLATE ? "deflate" : "identity";
+    Serial.printf("%s: %u wire bytes, %u decoded bytes (%s), inflate %lu us\n", endpoint, m_wireBytes, m_decodedBytes, encoding, m_inflateMicros);
+}
+
+// Reads the stream header and sets up the decompressor on first use
+bool InflateStream::begin() {
+    m_started = true;
+    m_windowSize = INFLATE_MAX_WINDOW;
+    if (m_encoding == GZIP) {
+        if (!skipGzipHeader()) {
+            Serial.println("Invalid gzip header");
+            m_error = true;
+            return false;
+        }
+    } else {
+        // "deflate" should be zlib wrapped but some servers send a raw stream
+        while (m_inputEnd - m_inputPos < 2 && readSource()) {
+        }
+        if (m_inputEnd - m_inputPos >= 2) {
+            uint8_t cmf = m_input[m_inputPos];
+            uint8_t flg = m_input[m_inputPos + 1];
+            if ((cmf & 0x0F) == 8 && ((cmf << 8) | flg) % 31 == 0) {
+                m_flags = TINFL_FLAG_PARSE_ZLIB_HEADER;
+                // zlib announces the window the sender used, no need to reserve more
+                m_windowSize = 1 << ((cmf >> 4) + 8);
+            }
+        }
+    }
+    // the window is the largest single allocation a fetch makes
+    MemoryGovernor::getInstance()->reserve(sizeof(tinfl_decompressor) + m_windowSize, "inflate window");
+    m_decompressor = (tinfl_decompressor *)malloc(sizeof(tinfl_decompressor));
+    m_window = (uint8_t *)malloc(m_windowSize);
+    if (m_decompressor == nullptr || m_window == nullptr) {
+        Serial.printf("Not enough memory to inflate response (%u byte window)\n", m_windowSize);
+        m_error = true;
+        return false;
+    }
+    tinfl_init(m_decompressor);
+    return true;
+}
+
+// Inflates the next run of output into the window
+bool InflateStream::fill() {
+    if (!m_started && !begin()) {
+        return false;
+    }
+    if (m_done || m_error) {
+        return false;
+    }
+    if (m_windowPos == m_windowSize) {
+        m_windowPos = 0;
+    }
+    for (;;) {
+        if (m_inputPos == m_inputEnd && !m_sourceDone) {
+            readSource();
+        }
+        size_t inSize = m_inputEnd - m_inputPos;
+        // the output size has to reach the end of the window for tinfl to treat it as circular
+        size_t outSize = m_windowSize - m_windowPos;
+        mz_uint32 flags = m_flags | (m_sourceDone ? 0 : TINFL_FLAG_HAS_MORE_INPUT);
+
+        unsigned long start = micros();
+        tinfl_status status = tinfl_decompress(m_decompressor, m_input + m_inputPos, &inSize, m_window, m_window + m_windowPos, &outSize, flags);
+        m_inflateMicros += micros() - start;
+
+        m_inputPos += inSize;
+        m_readPos = m_windowPos;
+        m_readEnd = m_windowPos + outSize;
+        m_windowPos += outSize;
+        m_decodedBytes += outSize;
+
+        if (status < TINFL_STATUS_DONE) {
+            Serial.printf("Inflate failed, status: %d\n", status);
+            m_error = true;
+            return outSize > 0;
+        }
+        if (status == TINFL_STATUS_DONE) {
+            m_done = true;
+            return outSize > 0;
+        }
+        if (outSize > 0) {
+            return true;
+        }
+        if (m_sourceDone) {
+            Serial.println("Compressed response ended early");
+            m_error = true;
+            return false;
+        }
+    }
+}
+
+// Refills the input buffer, waiting up to the source's timeout for data
+bool InflateStream::readSource() {
+    if (m_inputPos == m_inputEnd) {
+        m_inputPos = 0;
+        m_inputEnd = 0;
+    }
+    int available = m_source.available();
+    size_t space = INFLATE_INPUT_SIZE - m_inputEnd;
+    size_t want = available > 0 ? min((size_t)available, space) : 1;
+    size_t count = m_source.readBytes(m_input + m_inputEnd, want);
+    if (count == 0) {
+        m_sourceDone = true;
+        return false;
+    }
+    m_inputEnd += count;
+    m_wireBytes += count;
+    return true;
+}
+
+int InflateStream::nextSourceByte() {
+    if (m_inputPos == m_inputEnd && !readSource()) {
+        return -1;
+    }
+    return m_input[m_inputPos++];
+}
+
+// RFC 1952 member header, only the deflate payload behind it is passed to tinfl
+bool InflateStream::skipGzipHeader() {
+    uint8_t header[10];
+    for (int i = 0; i < 10; i++) {
+        int c = nextSourceByte();
+        if (c < 0) {
+            return false;
+        }
+        header[i] = c;
+    }
+    if (header[0] != 0x1f || header[1] != 0x8b || header[2] != 8) {
+        return false;
+    }
+    uint8_t flags = header[3];
+    if (flags & GZIP_FEXTRA) {
+        int lo = nextSourceByte();
+        int hi = nextSourceByte();
+        if (lo < 0 || hi < 0) {
+            return false;
+        }
+        for (int length = lo | (hi << 8); length > 0; length--) {
+            if (nextSourceByte() < 0) {
+                return false;
+            }
+        }
+    }
+    if (flags & GZIP_FNAME) {
+        int c;
+        while ((c = nextSourceByte()) > 0) {
+        }
+        if (c < 0) {
+            return false;
+        }
+    }
+    if (flags & GZIP_FCOMMENT) {
+        int c;
+        while ((c = nextSourceByte()) > 0) {
+        }
+        if (c < 0) {
+            return false;
+        }
+    }
+    if (flags & GZIP_FHCRC) {
+        if (nextSourceByte() < 0 || nextSourceByte() < 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,72 @@
+#ifndef INFLATE_STREAM_H
+#define INFLATE_STREAM_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+
+#include "rom/miniz.h"
+
+#define INFLATE_INPUT_SIZE 512     // compressed bytes read from the socket at a time
+#define INFLATE_MAX_WINDOW 32768   // largest deflate window, gzip always needs this much
+
+// Wraps a response body and inflates gzip or deflate Content-Encoding on the
+// fly with the ROM miniz inflater. Decoded bytes come out of the deflate
+// window itself, so neither the compressed nor the decoded body is ever held
+// in full. Identity bodies are passed straight through. Either way it counts
+// wire and decoded bytes so each endpoint can report what compression saves.
+class InflateStream : public Stream {
+   public:
+    InflateStream(Stream &source, const String &contentEncoding);
+    ~InflateStream() override;
+
+    int available() override;
+    int read() override;
+    int peek() override;
+    size_t write(uint8_t) override;
+
+    bool hasError();
+    size_t getWireBytes();
+    size_t getDecodedBytes();
+    void printStats(const char *endpoint);
+
+    static void prepare(HTTPClient &http);
+
+   private:
+    enum Encoding {
+        IDENTITY,
+        GZIP,
+        DEFLATE
+    };
+
+    bool begin();
+    bool fill();
+    bool readSource();
+    int nextSourceByte();
+    bool skipGzipHeader();
+
+    Stream &m_source;
+    Encoding m_encoding = IDENTITY;
+    tinfl_decompressor *m_decompressor = nullptr;
+    mz_uint32 m_flags = 0;
+
+    uint8_t *m_window = nullptr;
+    size_t m_windowSize = 0;
+    size_t m_windowPos = 0;
+    size_t m_readPos = 0;
+    size_t m_readEnd = 0;
+
+    uint8_t m_input[INFLATE_INPUT_SIZE];
+    size_t m_inputPos = 0;
+    size_t m_inputEnd = 0;
+
+    bool m_started = false;
+    bool m_sourceDone = false;
+    bool m_done = false;
+    bool m_error = false;
+
+    size_t m_wireBytes = 0;
+    size_t m_decodedBytes = 0;
+    unsigned long m_inflateMicros = 0;
+};
+
+#endif
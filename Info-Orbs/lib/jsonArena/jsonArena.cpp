@@ -0,0 +1,99 @@
+#include "jsonArena.h"
+
+JsonArena::JsonArena(const char *name, uint8_t *buffer, size_t capacity) : m_name(name), m_buffer(buffer), m_capacity(capacity) {
+}
+
+size_t JsonArena::blockSize(size_t size) {
+    return sizeof(Header) + ((size + JSON_ARENA_ALIGN - 1) & ~(size_t)(JSON_ARENA_ALIGN - 1));
+}
+
+JsonArena::Header *JsonArena::header(void *ptr) {
+    return (Header *)ptr - 1;
+}
+
+bool JsonArena::isTop(void *ptr) {
+    return (uint8_t *)ptr + blockSize(header(ptr)->size) - sizeof(Header) == m_buffer + m_used;
+}
+
+void *JsonArena::allocate(size_t size) {
+    size_t needed = blockSize(size);
+    if (needed > m_capacity - m_used) {
+        m_failures++;
+        return nullptr;
+    }
+    Header *block = (Header *)(m_buffer + m_used);
+    block->size = size;
+    m_used += needed;
+    m_highWater = max(m_highWater, m_used);
+    m_liveBlocks++;
+    return block + 1;
+}
+
+void JsonArena::deallocate(void *ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+    if (isTop(ptr)) {
+        m_used = (uint8_t *)header(ptr) - m_buffer;
+    }
+    if (--m_liveBlocks == 0) {
+        m_used = 0;
+    }
+}
+
+// The pools and strings ArduinoJson grows or shrinks are usually the newest
+// block, those are resized in place
+void *JsonArena::reallocate(void *ptr, size_t size) {
+    if (ptr == nullptr) {
+        return allocate(size);
+    }
+    Header *block = header(ptr);
+    if (isTop(ptr)) {
+        size_t start = (uint8_t *)block - m_buffer;
+        if (blockSize(size) > m_capacity - start) {
+            m_failures++;
+            return nullptr;
+        }
+        block->size = size;
+        m_used = start + blockSize(size);
+        m_highWater = max(m_highWater, m_used);
+        return ptr;
+    }
+    if (size <= block->size) {
+        block->size = size;
+        return ptr;
+    }
+    void *moved = allocate(size);
+    if (moved != nullptr) {
+        memcpy(moved, ptr, block->size);
+        m_liveBlocks--;
+    }
+    return moved;
+}
+
+// Only when no document uses the arena anymore, normally that happens by itself
+void JsonArena::reset() {
+    m_used = 0;
+    m_liveBlocks = 0;
+}
+
+size_t JsonArena::getUsed() {
+    return m_used;
+}
+
+size_t JsonArena::getHighWater() {
+    return m_highWater;
+}
+
+size_t JsonArena::getCapacity() {
+    return m_capacity;
+}
+
+uint32_t JsonArena::getFailures() {
+    return m_failures;
+}
+
+// The high water mark is what the arena should be sized to, with some room for larger payloads
+void JsonArena::printStats() {
+    Serial.printf("%s JSON arena: %u of %u bytes used, high water %u, %u failed allocations\n", m_name, m_used, m_capacity, m_highWater, m_failures);
+}
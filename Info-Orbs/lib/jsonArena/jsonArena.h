@@ -0,0 +1,61 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+#define JSON_ARENA_ALIGN 8  // doubles and 64 bit integers live in the pool slots
+
+// ArduinoJson allocator that bumps through a buffer reserved up front, so
+// parsing never fragments the global heap. Freed blocks are only reclaimed
+// from the top, the arena starts over once every block is freed, which is
+// when the JsonDocument using it goes away. A payload that doesn't fit makes
+// the parse fail with NoMemory.
+//
+//     StaticJsonArena<4096> m_arena{"stock"};
+//     JsonDocument doc(&m_arena);
+class JsonArena : public ArduinoJson::Allocator {
+   public:
+    JsonArena(const char *name, uint8_t *buffer, size_t capacity);
+
+    void *allocate(size_t size) override;
+    void deallocate(void *ptr) override;
+    void *reallocate(void *ptr, size_t size) override;
+
+    void reset();
+    size_t getUsed();
+    size_t getHighWater();
+    size_t getCapacity();
+    uint32_t getFailures();
+    void printStats();
+
+   private:
+    struct Header {
+        uint32_t size;
+        uint32_t padding;  // keeps the block JSON_ARENA_ALIGN aligned
+    };
+
+    static size_t blockSize(size_t size);
+    Header *header(void *ptr);
+    bool isTop(void *ptr);
+
+    const char *m_name;
+    uint8_t *m_buffer;
+    size_t m_capacity;
+    size_t m_used = 0;
+    size_t m_highWater = 0;
+    uint32_t m_liveBlocks = 0;
+    uint32_t m_failures = 0;
+};
+
+// Arena with its buffer inline, for use as a member or static
+template <size_t N>
+class StaticJsonArena : public JsonArena {
+   public:
+    explicit StaticJsonArena(const char *name) : JsonArena(name, m_storage, N) {}
+
+   private:
+    alignas(JSON_ARENA_ALIGN) uint8_t m_storage[N];
+};
+
+#endif
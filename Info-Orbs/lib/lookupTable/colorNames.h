@@ -0,0 +1,41 @@
+#ifndef COLOR_NAMES_H
+#define COLOR_NAMES_H
+
+#include <TFT_eSPI.h>
+
+#include "lookupTable.h"
+
+// Color names Utils::stringToColor accepts, "grey" and the misspelled
+// "vilolet" are kept for existing WebData servers
+static constexpr LookupEntry<int32_t> COLOR_NAME_ENTRIES[] = {
+    {"black", TFT_BLACK},
+    {"navy", TFT_NAVY},
+    {"darkgreen", TFT_DARKGREEN},
+    {"darkcyan", TFT_DARKCYAN},
+    {"maroon", TFT_MAROON},
+    {"purple", TFT_PURPLE},
+    {"olive", TFT_OLIVE},
+    {"lightgrey", TFT_LIGHTGREY},
+    {"grey", TFT_LIGHTGREY},
+    {"darkgrey", TFT_DARKGREY},
+    {"blue", TFT_BLUE},
+    {"green", TFT_GREEN},
+    {"cyan", TFT_CYAN},
+    {"red", TFT_RED},
+    {"magenta", TFT_MAGENTA},
+    {"yellow", TFT_YELLOW},
+    {"white", TFT_WHITE},
+    {"orange", TFT_ORANGE},
+    {"greenyellow", TFT_GREENYELLOW},
+    {"pink", TFT_PINK},
+    {"brown", TFT_BROWN},
+    {"gold", TFT_GOLD},
+    {"silver", TFT_SILVER},
+    {"skyblue", TFT_SKYBLUE},
+    {"violet", TFT_VIOLET},
+    {"vilolet", TFT_VIOLET},
+};
+
+static constexpr auto COLOR_NAMES = makeLookupTable<int32_t>(COLOR_NAME_ENTRIES);
+
+#endif
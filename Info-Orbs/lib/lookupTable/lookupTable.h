@@ -0,0 +1,138 @@
+#ifndef LOOKUP_TABLE_H
+#define LOOKUP_TABLE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Compile-time perfect hash from string keys to values. Keys match case
+// insensitively and spaces are ignored, so "Dark Green" finds "darkgreen".
+// The seed that makes every key land in its own slot is searched by the
+// compiler, a lookup is one hash and one key compare without allocating.
+//
+//     static constexpr auto colors = makeLookupTable<int32_t>({{"red", TFT_RED}, {"blue", TFT_BLUE}});
+//     int32_t color = colors.get(name, TFT_BLACK);
+
+namespace lookup {
+
+constexpr char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? c - 'A' + 'a' : c;
+}
+
+constexpr uint32_t hash(const char *key, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (; *key != '\0'; key++) {
+        if (*key != ' ') {
+            hash = (hash ^ (uint8_t)lower(*key)) * 16777619u;
+        }
+    }
+    // the multiply only carries upwards, fold the high bits into the slot bits
+    return hash ^ (hash >> 16);
+}
+
+constexpr bool equals(const char *a, const char *b) {
+    while (true) {
+        while (*a == ' ') {
+            a++;
+        }
+        while (*b == ' ') {
+            b++;
+        }
+        if (lower(*a) != lower(*b)) {
+            return false;
+        }
+        if (*a == '\0') {
+            return true;
+        }
+        a++;
+        b++;
+    }
+}
+
+// Power of two with at least twice as many slots as keys
+constexpr size_t slotCount(size_t keys) {
+    size_t slots = 1;
+    while (slots < keys * 2) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+// Not constexpr on purpose, reaching it makes the table fail to compile
+void noPerfectSeed();
+
+}  // namespace lookup
+
+template <typename V>
+struct LookupEntry {
+    const char *key;
+    V value;
+};
+
+template <typename V, size_t N>
+class LookupTable {
+   public:
+    static constexpr size_t SLOTS = lookup::slotCount(N);
+    static constexpr uint8_t EMPTY = 0xFF;
+    static_assert(N < EMPTY, "too many keys for a LookupTable");
+
+    constexpr LookupTable(const LookupEntry<V> (&entries)[N]) : m_entries(), m_slots(), m_seed(0) {
+        for (size_t i = 0; i < N; i++) {
+            m_entries[i] = entries[i];
+        }
+        m_seed = findSeed();
+        for (size_t i = 0; i < SLOTS; i++) {
+            m_slots[i] = EMPTY;
+        }
+        for (size_t i = 0; i < N; i++) {
+            m_slots[slot(m_entries[i].key, m_seed)] = i;
+        }
+    }
+
+    // Returns false and leaves value alone when key is unknown
+    bool find(const char *key, V &value) const {
+        uint8_t index = m_slots[slot(key, m_seed)];
+        if (index == EMPTY || !lookup::equals(key, m_entries[index].key)) {
+            return false;
+        }
+        value = m_entries[index].value;
+        return true;
+    }
+
+    V get(const char *key, V fallback) const {
+        find(key, fallback);
+        return fallback;
+    }
+
+   private:
+    static constexpr size_t slot(const char *key, uint32_t seed) {
+        return lookup::hash(key, seed) & (SLOTS - 1);
+    }
+
+    constexpr uint32_t findSeed() const {
+        for (uint32_t seed = 0; seed < 100000; seed++) {
+            bool used[SLOTS] = {};
+            bool collision = false;
+            for (size_t i = 0; i < N && !collision; i++) {
+                size_t s = slot(m_entries[i].key, seed);
+                collision = used[s];
+                used[s] = true;
+            }
+            if (!collision) {
+                return seed;
+            }
+        }
+        lookup::noPerfectSeed();
+        return 0;
+    }
+
+    LookupEntry<V> m_entries[N];
+    uint8_t m_slots[SLOTS];
+    uint32_t m_seed;
+};
+
+template <typename V, size_t N>
+constexpr LookupTable<V, N> makeLookupTable(const LookupEntry<V> (&entries)[N]) {
+    return LookupTable<V, N>(entries);
+}
+
+#endif
@@ -0,0 +1,99 @@
+#include "memoryGovernor.h"
+
+#include <esp_heap_caps.h>
+
+MemoryGovernor *MemoryGovernor::m_instance = nullptr;
+
+MemoryGovernor::MemoryGovernor() {
+}
+
+MemoryGovernor *MemoryGovernor::getInstance() {
+    if (m_instance == nullptr) {
+        m_instance = new MemoryGovernor();
+    }
+    return m_instance;
+}
+
+// Consumers are kept sorted by priority, equal priorities in the order they registered
+bool MemoryGovernor::add(MemoryConsumer *consumer, const char *name, uint8_t priority) {
+    if (m_consumerCount == MEMORY_GOVERNOR_MAX_CONSUMERS) {
+        Serial.printf("Memory governor: no room for %s\n", name);
+        return false;
+    }
+    int i = m_consumerCount++;
+    for (; i > 0 && m_consumers[i - 1].priority > priority; i--) {
+        m_consumers[i] = m_consumers[i - 1];
+    }
+    m_consumers[i] = {consumer, name, priority, 0, 0};
+    return true;
+}
+
+void MemoryGovernor::remove(MemoryConsumer *consumer) {
+    for (int i = 0; i < m_consumerCount; i++) {
+        if (m_consumers[i].consumer == consumer) {
+            for (int j = i + 1; j < m_consumerCount; j++) {
+                m_consumers[j - 1] = m_consumers[j];
+            }
+            m_consumerCount--;
+            return;
+        }
+    }
+}
+
+// Cheap enough for every loop, the heap is only looked at once per interval
+void MemoryGovernor::update() {
+    if (millis() - m_lastCheck < MEMORY_GOVERNOR_CHECK_INTERVAL) {
+        return;
+    }
+    m_lastCheck = millis();
+    if (getLargestBlock() < MEMORY_GOVERNOR_LOW_BLOCK) {
+        release(MEMORY_GOVERNOR_TARGET_BLOCK, "low memory");
+    }
+}
+
+// Makes sure an allocation of bytes can succeed, with the usual headroom left
+// over for everything else. Returns false when even shedding every cache
+// didn't free a large enough block.
+bool MemoryGovernor::reserve(size_t bytes, const char *reason) {
+    size_t target = bytes + MEMORY_GOVERNOR_LOW_BLOCK;
+    if (getLargestBlock() >= target) {
+        return true;
+    }
+    return release(target, reason);
+}
+
+// Asks one consumer at a time, cheapest to lose first, until the largest
+// block reaches target. Frees are measured rather than trusted to the
+// consumer, fragmentation decides what a release is actually worth.
+bool MemoryGovernor::release(size_t target, const char *reason) {
+    for (int i = 0; i < m_consumerCount && getLargestBlock() < target; i++) {
+        Consumer &consumer = m_consumers[i];
+        size_t freeBefore = ESP.getFreeHeap();
+        size_t blockBefore = getLargestBlock();
+        if (!consumer.consumer->releaseMemory()) {
+            continue;
+        }
+        size_t freed = ESP.getFreeHeap() > freeBefore ? ESP.getFreeHeap() - freeBefore : 0;
+        consumer.releases++;
+        consumer.freedBytes += freed;
+        Serial.printf("Memory governor (%s): released %s, freed %u bytes, largest block %u -> %u, want %u\n", reason, consumer.name, freed, blockBefore, getLargestBlock(), target);
+    }
+    if (getLargestBlock() < target) {
+        m_shortfalls++;
+        Serial.printf("Memory governor (%s): largest block %u of %u wanted after releasing everything\n", reason, getLargestBlock(), target);
+        return false;
+    }
+    return true;
+}
+
+size_t MemoryGovernor::getLargestBlock() {
+    return heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+}
+
+void MemoryGovernor::printStatus() {
+    Serial.printf("Memory governor: %u free, largest block %u, %u shortfalls\n", ESP.getFreeHeap(), getLargestBlock(), m_shortfalls);
+    for (int i = 0; i < m_consumerCount; i++) {
+        Consumer &consumer = m_consumers[i];
+        Serial.printf("  %-20s priority %3u, %u releases, %u bytes freed\n", consumer.name, consumer.priority, consumer.releases, consumer.freedBytes);
+    }
+}
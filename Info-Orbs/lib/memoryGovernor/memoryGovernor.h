@@ -0,0 +1,72 @@
+#ifndef MEMORY_GOVERNOR_H
+#define MEMORY_GOVERNOR_H
+
+#include <Arduino.h>
+
+#define MEMORY_GOVERNOR_MAX_CONSUMERS 8
+#define MEMORY_GOVERNOR_LOW_BLOCK 24576       // shed caches when the largest free block drops below this
+#define MEMORY_GOVERNOR_TARGET_BLOCK 32768    // and keep shedding until it is back above this
+#define MEMORY_GOVERNOR_CHECK_INTERVAL 1000   // how often the heap is checked from the loop (ms)
+
+// Heap reserved up front with every widget configured, sizes as on the ESP32:
+//
+//     DataSource JSON arena            16 KB  one, shared by all polled URLs
+//     Weather JSON arena               12 KB
+//     Stock JSON arena                  3 KB
+//     MQTT arena, pool and displays    27 KB  8 KB + 9.5 KB pool + 5 x 1.9 KB
+//     WebData pool and displays        19 KB  per WebData URL
+//     WebData stream arena              8 KB  per connected stream, freed when it drops
+//     Image cache index               2.5 KB
+//
+// Two WebData URLs come to about 99 KB, 115 KB with both streams connected.
+// An ESP32 without PSRAM has roughly 200 KB of heap left once WiFi is up.
+// That leaves about 85 KB for TLS handshakes (around 45 KB each), HTTP
+// buffers and sprites. setup() logs the heap once everything is allocated.
+
+// Something holding heap it can give back and rebuild later
+class MemoryConsumer {
+   public:
+    virtual ~MemoryConsumer() = default;
+    // Frees what can be rebuilt, returns false when there was nothing to free
+    virtual bool releaseMemory() = 0;
+};
+
+// Watches the largest free heap block and asks registered consumers to
+// release memory before an allocation fails, lowest priority first. Besides
+// the periodic check, code about to make a large allocation can reserve()
+// the block it needs. Every release is logged with what it freed so cache
+// budgets can be tuned from the serial log.
+class MemoryGovernor {
+   public:
+    static MemoryGovernor *getInstance();
+
+    bool add(MemoryConsumer *consumer, const char *name, uint8_t priority);
+    void remove(MemoryConsumer *consumer);
+    void update();
+    bool reserve(size_t bytes, const char *reason);
+
+    void printStatus();
+
+   private:
+    struct Consumer {
+        MemoryConsumer *consumer;
+        const char *name;
+        uint8_t priority;  // lower is released first
+        uint16_t releases;
+        uint32_t freedBytes;
+    };
+
+    MemoryGovernor();
+
+    bool release(size_t target, const char *reason);
+    static size_t getLargestBlock();
+
+    static MemoryGovernor *m_instance;
+
+    Consumer m_consumers[MEMORY_GOVERNOR_MAX_CONSUMERS];
+    int8_t m_consumerCount = 0;
+    unsigned long m_lastCheck = 0;
+    uint16_t m_shortfalls = 0;  // times shedding everything still wasn't enough
+};
+
+#endif
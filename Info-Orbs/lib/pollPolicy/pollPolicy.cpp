@@ -0,0 +1,102 @@
+#include "pollPolicy.h"
+
+#include <globalTime.h>
+
+PollPolicy::PollPolicy(unsigned long interval, unsigned long minInterval, unsigned long maxInterval)
+    : m_interval(interval), m_minInterval(minInterval), m_maxInterval(maxInterval) {
+}
+
+bool PollPolicy::isDue() {
+    if (!m_polled) {
+        return true;
+    }
+    if (m_marketHours && isTimeKnown()) {
+        bool open = isMarketOpen(GlobalTime::getInstance()->getUtcEpoch());
+        if (open != m_wasMarketOpen) {
+            // fetch right away at the opening bell and once more for the closing prices
+            m_wasMarketOpen = open;
+            return true;
+        }
+    }
+    return millis() - m_lastPoll >= getInterval();
+}
+
+void PollPolicy::onResult(bool changed) {
+    unsigned long interval = m_interval;
+    if (changed) {
+        interval = max(m_minInterval, m_interval / 2);
+    } else {
+        interval = min(m_maxInterval, (unsigned long)(m_interval * POLL_BACKOFF_FACTOR));
+    }
+    if (interval != m_interval) {
+        m_interval = interval;
+        Serial.printf("Poll interval now %lus\n", getInterval() / 1000);
+    }
+    m_lastPoll = millis();
+    m_polled = true;
+}
+
+void PollPolicy::onFailure() {
+    m_lastPoll = millis();
+    m_polled = true;
+}
+
+void PollPolicy::setMaxAge(long seconds) {
+    m_maxAge = seconds > 0 ? seconds * 1000 : 0;
+}
+
+// Picks max-age out of a Cache-Control header, anything else clears it
+void PollPolicy::setMaxAge(const String &cacheControl) {
+    int index = cacheControl.indexOf("max-age=");
+    if (index == -1) {
+        setMaxAge(0L);
+        return;
+    }
+    setMaxAge(cacheControl.substring(index + 8).toInt());
+}
+
+void PollPolicy::setMarketHours(bool marketHours) {
+    m_marketHours = marketHours;
+}
+
+unsigned long PollPolicy::getInterval() {
+    unsigned long interval = m_interval;
+    if (m_marketHours && isTimeKnown() && !isMarketOpen(GlobalTime::getInstance()->getUtcEpoch())) {
+        interval = POLL_MARKET_CLOSED_INTERVAL;
+    }
+    return max(interval, m_maxAge);
+}
+
+// NYSE/Nasdaq regular session, 9:30-16:00 America/New_York, Monday to Friday
+bool PollPolicy::isMarketOpen(time_t utc) {
+    int y = year(utc);
+    // US daylight saving time starts the second Sunday of March and ends the
+    // first Sunday of November, both at 2:00 local time
+    time_t dstStart = nthSunday(y, 3, 2) + 7 * SECS_PER_HOUR;
+    time_t dstEnd = nthSunday(y, 11, 1) + 6 * SECS_PER_HOUR;
+    bool dst = utc >= dstStart && utc < dstEnd;
+    time_t local = utc - (dst ? 4 : 5) * SECS_PER_HOUR;
+
+    int wd = weekday(local);
+    if (wd == 1 || wd == 7) {
+        return false;
+    }
+    int minutes = hour(local) * 60 + minute(local);
+    return minutes >= 9 * 60 + 30 && minutes < 16 * 60;
+}
+
+// Until NTP has synced the calendar can't be trusted, poll as if the market was open
+bool PollPolicy::isTimeKnown() {
+    return GlobalTime::getInstance()->getYear() >= 2024;
+}
+
+// Midnight UTC of the nth Sunday of the given month
+time_t PollPolicy::nthSunday(int year, int month, int n) {
+    tmElements_t tm = {};
+    tm.Year = CalendarYrToTm(year);
+    tm.Month = month;
+    tm.Day = 1;
+    time_t first = makeTime(tm);
+    int firstSunday = 1 + (8 - weekday(first)) % 7;
+    return first + (firstSunday - 1 + 7 * (n - 1)) * SECS_PER_DAY;
+}
@@ -0,0 +1,42 @@
+#ifndef POLL_POLICY_H
+#define POLL_POLICY_H
+
+#include <Arduino.h>
+#include <TimeLib.h>
+
+#define POLL_BACKOFF_FACTOR 1.5          // interval growth after a response that changed nothing
+#define POLL_MARKET_CLOSED_INTERVAL 14400000  // 4h between polls while the exchange is closed
+
+// Decides when a widget should fetch its data again. The interval stretches
+// while responses leave the model unchanged and snaps back when values move.
+// It never goes below a server provided Cache-Control max-age.
+class PollPolicy {
+   public:
+    PollPolicy(unsigned long interval, unsigned long minInterval, unsigned long maxInterval);
+
+    bool isDue();
+    void onResult(bool changed);
+    void onFailure();
+
+    void setMaxAge(long seconds);
+    void setMaxAge(const String &cacheControl);
+    void setMarketHours(bool marketHours);
+    unsigned long getInterval();
+
+    static bool isMarketOpen(time_t utc);
+
+   private:
+    static bool isTimeKnown();
+    static time_t nthSunday(int year, int month, int n);
+
+    unsigned long m_interval;
+    unsigned long m_minInterval;
+    unsigned long m_maxInterval;
+    unsigned long m_maxAge = 0;
+    unsigned long m_lastPoll = 0;
+    bool m_polled = false;
+    bool m_marketHours = false;
+    bool m_wasMarketOpen = false;
+};
+
+#endif
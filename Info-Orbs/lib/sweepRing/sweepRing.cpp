@@ -0,0 +1,135 @@
+#include "sweepRing.h"
+
+SweepRing::SweepRing(int16_t cx, int16_t cy, int16_t innerRadius, int16_t outerRadius, uint8_t fps, uint32_t frameBudget)
+    : m_cx(cx), m_cy(cy), m_innerRadius(innerRadius), m_outerRadius(outerRadius), m_fps(fps), m_frameBudget(frameBudget) {
+}
+
+// The next frame paints the whole ring, e.g. after the screen was cleared
+void SweepRing::reset() {
+    m_redraw = true;
+}
+
+bool SweepRing::isFrameDue(int64_t epochMillis) {
+    return m_redraw || epochMillis * m_fps / 1000 != m_lastFrame;
+}
+
+void SweepRing::drawFrame(TFT_eSPI &display, int64_t epochMillis, uint16_t color, uint16_t background) {
+    int64_t frame = epochMillis * m_fps / 1000;
+    if (m_lastFrame >= 0 && frame > m_lastFrame + 1) {
+        m_droppedFrames += frame - m_lastFrame - 1;
+    }
+    m_lastFrame = frame;
+    m_frames++;
+
+    int64_t minute = epochMillis / 60000;
+    float target = (epochMillis % 60000) * 360.0f / 60000;
+    if (minute != m_minute && !m_redraw) {
+        if (minute == m_minute + 1) {
+            // finish the sweep of the minute that just ended
+            fillWedge(display, m_drawnAngle, 360, m_minute % 2 == 0 ? color : background, 0);
+            m_drawnAngle = 0;
+        } else {
+            m_redraw = true;
+        }
+    } else if (target < m_drawnAngle) {
+        // the clock was stepped back
+        m_redraw = true;
+    }
+    m_minute = minute;
+    uint16_t sweep = minute % 2 == 0 ? color : background;
+    unsigned long deadline = micros() + m_frameBudget;
+    if (m_redraw) {
+        fillWedge(display, 0, 360, minute % 2 == 0 ? background : color, 0);
+        m_drawnAngle = 0;
+        m_redraw = false;
+        deadline = 0;
+    }
+    float from = m_drawnAngle;
+    while (from < target) {
+        float to = min(from + (float)SWEEP_RING_CHUNK, target);
+        if (!fillWedge(display, from, to, sweep, deadline)) {
+            m_overBudget++;
+            break;
+        }
+        from = to;
+    }
+    m_drawnAngle = from;
+}
+
+// Draws the wedge unless the deadline (micros, 0 for none) has already passed
+bool SweepRing::fillWedge(TFT_eSPI &display, float from, float to, uint16_t color, unsigned long deadline) {
+    if (deadline != 0 && (long)(micros() - deadline) >= 0) {
+        return false;
+    }
+    while (from < to) {
+        float end = min(from + (float)SWEEP_RING_MAX_WEDGE, to);
+        rasterise(display, from, end, color);
+        from = end;
+    }
+    return true;
+}
+
+// Scans the bounding box of a wedge of at most SWEEP_RING_MAX_WEDGE degrees
+// and draws each row of pixel centres inside it as one line. Angles run
+// clockwise from 12 o'clock, a pixel on the closing edge belongs to the next
+// wedge so neighbours neither overlap nor leave gaps.
+void SweepRing::rasterise(TFT_eSPI &display, float from, float to, uint16_t color) {
+    float x0 = sinf(from * DEG_TO_RAD);
+    float y0 = -cosf(from * DEG_TO_RAD);
+    float x1 = sinf(to * DEG_TO_RAD);
+    float y1 = -cosf(to * DEG_TO_RAD);
+
+    float left = min(x0, x1) * m_innerRadius;
+    float right = max(x0, x1) * m_innerRadius;
+    float top = min(y0, y1) * m_innerRadius;
+    float bottom = max(y0, y1) * m_innerRadius;
+    for (float angle = from; angle < to + 5; angle += 5) {
+        float a = min(angle, to) * DEG_TO_RAD;
+        left = min(left, sinf(a) * m_outerRadius);
+        right = max(right, sinf(a) * m_outerRadius);
+        top = min(top, -cosf(a) * m_outerRadius);
+        bottom = max(bottom, -cosf(a) * m_outerRadius);
+    }
+
+    float inner2 = (float)m_innerRadius * m_innerRadius;
+    float outer2 = (float)m_outerRadius * m_outerRadius;
+    int16_t xStart = m_cx + (int16_t)floorf(left) - 1;
+    int16_t xEnd = m_cx + (int16_t)ceilf(right) + 1;
+    int16_t yStart = m_cy + (int16_t)floorf(top) - 1;
+    int16_t yEnd = m_cy + (int16_t)ceilf(bottom) + 1;
+    for (int16_t y = yStart; y <= yEnd; y++) {
+        float py = y + 0.5f - m_cy;
+        int16_t runStart = -1;
+        for (int16_t x = xStart; x <= xEnd + 1; x++) {
+            float px = x + 0.5f - m_cx;
+            float d2 = px * px + py * py;
+            bool inside = x <= xEnd && d2 >= inner2 && d2 < outer2 && x0 * py - y0 * px >= 0 && px * y1 - py * x1 > 0;
+            if (inside && runStart < 0) {
+                runStart = x;
+            } else if (!inside && runStart >= 0) {
+                display.drawFastHLine(runStart, y, x - runStart, color);
+                runStart = -1;
+            }
+        }
+    }
+}
+
+float SweepRing::getFps() {
+    unsigned long elapsed = millis() - m_statsStart;
+    return elapsed == 0 ? 0 : m_frames * 1000.0f / elapsed;
+}
+
+uint32_t SweepRing::getDroppedFrames() {
+    return m_droppedFrames;
+}
+
+void SweepRing::printStats() {
+    Serial.printf("Sweep ring: %.1f fps of %u, %u frames dropped, %u cut short by the %u us budget\n", getFps(), m_fps, m_droppedFrames, m_overBudget, m_frameBudget);
+}
+
+void SweepRing::resetStats() {
+    m_frames = 0;
+    m_droppedFrames = 0;
+    m_overBudget = 0;
+    m_statsStart = millis();
+}
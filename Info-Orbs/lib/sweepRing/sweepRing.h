@@ -0,0 +1,49 @@
+#ifndef SWEEP_RING_H
+#define SWEEP_RING_H
+
+#include <TFT_eSPI.h>
+
+#define SWEEP_RING_CHUNK 6.0           // degrees drawn between budget checks
+#define SWEEP_RING_MAX_WEDGE 45.0      // larger wedges are rasterised in pieces
+
+// Seconds ring that sweeps continuously. Each frame only rasterises the thin
+// wedge between the last drawn angle and the current one. Even minutes fill
+// the ring and odd minutes erase it again, so there is never a full clear.
+// Frames are paced on the disciplined epoch and cut short once the frame
+// budget is spent, the rest of the wedge follows in the next frame.
+class SweepRing {
+   public:
+    SweepRing(int16_t cx, int16_t cy, int16_t innerRadius, int16_t outerRadius, uint8_t fps, uint32_t frameBudget);
+
+    void reset();
+    bool isFrameDue(int64_t epochMillis);
+    void drawFrame(TFT_eSPI &display, int64_t epochMillis, uint16_t color, uint16_t background);
+
+    float getFps();
+    uint32_t getDroppedFrames();
+    void printStats();
+    void resetStats();
+
+   private:
+    bool fillWedge(TFT_eSPI &display, float from, float to, uint16_t color, unsigned long deadline);
+    void rasterise(TFT_eSPI &display, float from, float to, uint16_t color);
+
+    int16_t m_cx;
+    int16_t m_cy;
+    int16_t m_innerRadius;
+    int16_t m_outerRadius;
+    uint8_t m_fps;
+    uint32_t m_frameBudget;  // us
+
+    bool m_redraw = true;
+    int64_t m_lastFrame = -1;
+    int64_t m_minute = 0;
+    float m_drawnAngle = 0;
+
+    uint32_t m_frames = 0;
+    uint32_t m_droppedFrames = 0;
+    uint32_t m_overBudget = 0;
+    unsigned long m_statsStart = 0;
+};
+
+#endif
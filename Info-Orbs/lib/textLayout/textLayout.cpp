@@ -0,0 +1,150 @@
+#include "textLayout.h"
+
+#define TEXT_LAYOUT_UNMEASURED 0xFF
+
+TextLayout::GlyphWidths TextLayout::m_cache[TEXT_LAYOUT_CACHED_FONTS];
+uint8_t TextLayout::m_cacheCount = 0;
+uint8_t TextLayout::m_cacheNext = 0;
+
+TextLayout::TextLayout(TFT_eSPI &display, uint8_t font, uint8_t size) : m_display(display), m_font(font), m_size(size) {
+    m_widths = getGlyphWidths(font, size);
+}
+
+// Wraps text into at most maxLines lines centred on firstLineY, firstLineY +
+// lineHeight and so on. Breaks at spaces where possible and mid word otherwise,
+// the last line is filled up to the ellipsis. Honours '\n' and stops at lines
+// the orb is too narrow for. Returns the line count, lines point into buffer.
+int TextLayout::wrap(const char *text, int firstLineY, int lineHeight, char *buffer, size_t bufferSize, const char **lines, int maxLines) {
+    int fontHeight = getFontHeight();
+    char *out = buffer;
+    char *bufferEnd = buffer + bufferSize;
+    const char *p = text;
+    int count = 0;
+    int lastWidth = 0;  // of the last line that fitted, the ellipsis goes there
+    while (*p != '\0' && count < maxLines) {
+        while (*p == ' ') {
+            p++;
+        }
+        int y = firstLineY + lineHeight * count;
+        int maxWidth = chordWidth(y - fontHeight / 2, y + fontHeight - fontHeight / 2);
+        if (maxWidth <= 0 || bufferEnd - out < 2) {
+            break;
+        }
+        const char *end = p;
+        const char *lastSpace = nullptr;
+        int width = 0;
+        while (*end != '\0' && *end != '\n') {
+            int w = charWidth(*end);
+            if (width + w > maxWidth || end - p >= bufferEnd - out - 1) {
+                break;
+            }
+            if (*end == ' ') {
+                lastSpace = end;
+            }
+            width += w;
+            end++;
+        }
+        const char *next = end;
+        bool lastLine = count == maxLines - 1;
+        if (*end != '\0' && *end != '\n' && *end != ' ' && lastSpace != nullptr && !lastLine) {
+            end = lastSpace;
+            next = lastSpace + 1;
+        } else if (end == p && *end != '\0' && *end != '\n') {
+            // not even one glyph fits, take it anyway so we make progress
+            end++;
+            next = end;
+        } else if (*end == '\n') {
+            next = end + 1;
+        }
+        while (end > p && end[-1] == ' ') {
+            end--;
+        }
+        memcpy(out, p, end - p);
+        out[end - p] = '\0';
+        lines[count++] = out;
+        lastWidth = maxWidth;
+        out += end - p + 1;
+        p = next;
+    }
+    while (*p == ' ' || *p == '\n') {
+        p++;
+    }
+    if (*p != '\0' && count > 0) {
+        ellipsize((char *)lines[count - 1], bufferEnd, lastWidth);
+    }
+    return count;
+}
+
+// Shortens the last line in place until it fits with "..." appended
+void TextLayout::ellipsize(char *line, char *bufferEnd, int maxWidth) {
+    size_t length = strlen(line);
+    int dotsWidth = textWidth("...", 3);
+    while (length > 0 && (textWidth(line, length) + dotsWidth > maxWidth || line + length + 4 > bufferEnd)) {
+        length--;
+    }
+    while (length > 0 && line[length - 1] == ' ') {
+        length--;
+    }
+    if (line + length + 4 <= bufferEnd) {
+        memcpy(line + length, "...", 4);
+    }
+}
+
+int TextLayout::textWidth(const char *text, size_t length) {
+    int width = 0;
+    for (size_t i = 0; i < length && text[i] != '\0'; i++) {
+        width += charWidth(text[i]);
+    }
+    return width;
+}
+
+// Printable ASCII comes from the cache, anything else is measured every time
+int TextLayout::charWidth(char c) {
+    if (c < TEXT_LAYOUT_FIRST_GLYPH || c > TEXT_LAYOUT_LAST_GLYPH) {
+        char glyph[2] = {c, '\0'};
+        m_display.setTextSize(m_size);
+        return m_display.textWidth(glyph, m_font);
+    }
+    uint8_t &width = m_widths->widths[c - TEXT_LAYOUT_FIRST_GLYPH];
+    if (width == TEXT_LAYOUT_UNMEASURED) {
+        char glyph[2] = {c, '\0'};
+        m_display.setTextSize(m_size);
+        width = min(m_display.textWidth(glyph, m_font), (int16_t)(TEXT_LAYOUT_UNMEASURED - 1));
+    }
+    return width;
+}
+
+int TextLayout::getFontHeight() {
+    m_display.setTextSize(m_size);
+    return m_display.fontHeight(m_font);
+}
+
+// Usable width of the orb for a line spanning top to bottom
+int TextLayout::chordWidth(int top, int bottom) {
+    int distance = max(abs(top - TEXT_LAYOUT_ORB_RADIUS), abs(bottom - TEXT_LAYOUT_ORB_RADIUS));
+    if (distance >= TEXT_LAYOUT_ORB_RADIUS) {
+        return 0;
+    }
+    int width = 2 * sqrt(TEXT_LAYOUT_ORB_RADIUS * TEXT_LAYOUT_ORB_RADIUS - distance * distance);
+    return width - 2 * TEXT_LAYOUT_MARGIN;
+}
+
+// Finds or claims the cache slot for font/size, evicting round robin
+TextLayout::GlyphWidths *TextLayout::getGlyphWidths(uint8_t font, uint8_t size) {
+    for (int i = 0; i < m_cacheCount; i++) {
+        if (m_cache[i].font == font && m_cache[i].size == size) {
+            return &m_cache[i];
+        }
+    }
+    GlyphWidths *widths;
+    if (m_cacheCount < TEXT_LAYOUT_CACHED_FONTS) {
+        widths = &m_cache[m_cacheCount++];
+    } else {
+        widths = &m_cache[m_cacheNext];
+        m_cacheNext = (m_cacheNext + 1) % TEXT_LAYOUT_CACHED_FONTS;
+    }
+    widths->font = font;
+    widths->size = size;
+    memset(widths->widths, TEXT_LAYOUT_UNMEASURED, sizeof(widths->widths));
+    return widths;
+}
@@ -0,0 +1,46 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <TFT_eSPI.h>
+
+#define TEXT_LAYOUT_ORB_RADIUS 120
+#define TEXT_LAYOUT_MARGIN 8         // kept clear inside the orb edge (px)
+#define TEXT_LAYOUT_CACHED_FONTS 4   // font/size combinations with cached glyph widths
+#define TEXT_LAYOUT_FIRST_GLYPH ' '
+#define TEXT_LAYOUT_LAST_GLYPH '~'
+
+// Wraps text by pixel width into the round orb, each line gets the width of
+// the circle at its height. Text that doesn't fit ends in "...". Lines are
+// written into a caller buffer, glyph widths are cached per font and size.
+class TextLayout {
+   public:
+    TextLayout(TFT_eSPI &display, uint8_t font, uint8_t size);
+
+    int wrap(const char *text, int firstLineY, int lineHeight, char *buffer, size_t bufferSize, const char **lines, int maxLines);
+    int textWidth(const char *text, size_t length);
+    int charWidth(char c);
+    int getFontHeight();
+
+    static int chordWidth(int top, int bottom);
+
+   private:
+    struct GlyphWidths {
+        uint8_t font;
+        uint8_t size;
+        uint8_t widths[TEXT_LAYOUT_LAST_GLYPH - TEXT_LAYOUT_FIRST_GLYPH + 1];
+    };
+
+    void ellipsize(char *line, char *bufferEnd, int maxWidth);
+    static GlyphWidths *getGlyphWidths(uint8_t font, uint8_t size);
+
+    static GlyphWidths m_cache[TEXT_LAYOUT_CACHED_FONTS];
+    static uint8_t m_cacheCount;
+    static uint8_t m_cacheNext;
+
+    TFT_eSPI &m_display;
+    uint8_t m_font;
+    uint8_t m_size;
+    GlyphWidths *m_widths;
+};
+
+#endif
@@ -1,5 +1,7 @@
 #include "widget.h"
 
+#include <bootProfiler.h>
+
 Widget::Widget(ScreenManager &manager): m_manager(manager) 
 {}
 
@@ -10,3 +12,12 @@ void Widget::setBusy(bool busy) {
         digitalWrite(BUSY_PIN, LOW);
     }
 }
+
+// Called from a widget's success path once data arrived and was parsed, the
+// first call per widget goes on the boot timeline
+void Widget::markDataReceived() {
+    if (!m_hasData) {
+        m_hasData = true;
+        BootProfiler::mark("first data", getName());
+    }
+}
@@ -12,9 +12,14 @@ public:
     virtual void update(bool force = false) = 0;
     virtual void draw(bool force = false) = 0;
     virtual void changeMode() = 0;
+    // Short name used in logs and heap accounting
+    virtual const char *getName() = 0;
     void setBusy(bool busy);
 
 protected:
+    void markDataReceived();
+
     ScreenManager& m_manager;
+    bool m_hasData = false;
 };
 #endif // WIDGET_H
\ No newline at end of file
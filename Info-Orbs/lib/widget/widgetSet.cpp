@@ -1,4 +1,6 @@
 #include <widgetSet.h>
+#include <bootProfiler.h>
+#include <heapAccounting.h>
 
 WidgetSet::WidgetSet(ScreenManager *sm) : m_screenManager(sm) {
 
@@ -9,6 +11,7 @@ void WidgetSet::add(Widget *widget) {
     return;
   }
   m_widgets[m_widgetCount] = widget;
+  HeapTagGuard tag(widget->getName());
   m_widgets[m_widgetCount]->setup();
   m_widgetCount++;
 
@@ -19,10 +22,21 @@ void WidgetSet::drawCurrent() {
     m_screenManager->clearAllScreens();
     m_clearScreensOnDrawCurrent = false;
   }
+  HeapTagGuard tag(m_widgets[m_currentWidget]->getName());
   m_widgets[m_currentWidget]->draw();
+  if (!m_drawn) {
+    m_drawn = true;
+    BootProfiler::mark("first draw", m_widgets[m_currentWidget]->getName());
+  }
 }
 void WidgetSet::updateCurrent() {
-  m_widgets[m_currentWidget]->update();
+  updateWidget(m_currentWidget);
+}
+
+void WidgetSet::updateWidget(int8_t index) {
+  HeapTagGuard tag(m_widgets[index]->getName());
+  m_widgets[index]->update();
+  m_updated[index] = true;
 }
 
 Widget *WidgetSet::getCurrent() {
@@ -55,6 +69,7 @@ void WidgetSet::prev() {
 
 void WidgetSet::switchWidget() {
   m_screenManager->clearAllScreens();
+  HeapTagGuard tag(getCurrent()->getName());
   getCurrent()->setup();
   getCurrent()->draw(true);
 }
@@ -76,9 +91,9 @@ void WidgetSet::showLoading() {
 }
 
 void WidgetSet::updateAll() {
-  for (int8_t i; i<m_widgetCount; i++) {
+  for (int8_t i = 0; i<m_widgetCount; i++) {
     Serial.println("updating widget #" + String(i));
-    m_widgets[i]->update();
+    updateWidget(i);
   }
 }
 
@@ -86,8 +101,21 @@ bool WidgetSet::initialUpdateDone() {
   return m_initialized;
 }
 
+// Only the visible widget is fetched before the first draw, prefetchNext()
+// brings the others up one per loop so buttons stay responsive meanwhile
 void WidgetSet::initializeAllWidgetsData() {
   showLoading();
-  updateAll();
+  updateCurrent();
   m_initialized = true;
 }
+
+void WidgetSet::prefetchNext() {
+  for (int8_t i = 0; i < m_widgetCount; i++) {
+    if (!m_updated[i]) {
+      Serial.println("prefetching widget #" + String(i));
+      updateWidget(i);
+      return;
+    }
+  }
+  BootProfiler::finish();
+}
@@ -20,6 +20,7 @@ public:
     void updateAll();
     bool initialUpdateDone();
     void initializeAllWidgetsData();
+    void prefetchNext();
     void setClearScreensOnDrawCurrent();
 
    private:
@@ -30,7 +31,10 @@ public:
     int8_t m_currentWidget = 0;
 
     bool m_initialized = false;
+    bool m_updated[MAX_WIDGETS] = {};  // updated at least once, the rest are prefetched after boot
+    bool m_drawn = false;
 
+    void updateWidget(int8_t index);
     void switchWidget();
 };
 #endif // WIDGET_SET_H
\ No newline at end of file
@@ -1,186 +1,100 @@
 #include "utils.h"
 
-int Utils::getWrappedLines(String (&lines)[MAX_WRAPPED_LINES], String str, int limit) {
-    char buf[str.length() + 1];
-    char lineBuf[limit + 1];
-    str.toCharArray(buf, str.length() + 1);
+#include <colorNames.h>
+#include <lookupTable.h>
 
-    char *p = buf;
-    char *eol;
-    int lineCount = 0;
-    for (int i = 0; i < MAX_WRAPPED_LINES; i++) {
-        if (p - buf > strlen(buf)) {
-            lines[i] = "";
-            continue;
-        }
-        eol = strchr(p, '\n');
-        if (eol == NULL) {
-            eol = p + strlen(p);
+// Accepts a color name, "#RRGGBB", "0xRRGGBB" or a four digit "0xXXXX" RGB565 value
+int32_t Utils::stringToColor(const char *color) {
+    int32_t value;
+    if (COLOR_NAMES.find(color, value)) {
+        return value;
+    }
+    const char *digits = color[0] == '#' ? color + 1 : (color[0] == '0' && lookup::lower(color[1]) == 'x') ? color + 2 : nullptr;
+    if (digits != nullptr) {
+        char *end;
+        uint32_t rgb = strtoul(digits, &end, 16);
+        size_t length = end - digits;
+        if (*end == '\0' && length == 6) {
+            return ((rgb >> 8) & 0xF800) | ((rgb >> 5) & 0x07E0) | ((rgb >> 3) & 0x001F);
         }
-
-        if (eol - p > limit) {
-            eol = p + limit;
-            while (*eol != ' ' && *eol != '\n' && eol > p) {
-                eol--;
-            }
+        if (*end == '\0' && length == 4 && digits != color + 1) {
+            return rgb;
         }
-        strncpy(lineBuf, p, eol - p);
-        lineBuf[eol - p] = '\0';
-
-        lines[i] = String(lineBuf);
-        lineCount++;
-        p = eol + 1;
     }
-    return lineCount;
+    Serial.print("Invalid color: ");
+    Serial.println(color);
+    return TFT_BLACK;
 }
 
-String Utils::getWrappedLine(String str, int limit, int lineNum, int maxLines) {
-    if (lineNum > maxLines) {
-        return "";
-    }
-    char buf[str.length() + 1];
-    char lineBuf[limit + 1];
-    str.toCharArray(buf, str.length() + 1);
-
-    String lines[maxLines];
-
-    char *p = buf;
-    char *eol;
-
-    for (int i = 0; i < maxLines && i <= lineNum; i++) {
-        if (p - buf > strlen(buf)) {
-            lines[i] = "";
-            continue;
-        }
-        eol = strchr(p, '\n');
-        if (eol == NULL) {
-            eol = p + strlen(p);
-        }
-
-        if (eol - p > limit) {
-            eol = p + limit;
-            while (*eol != ' ' && *eol != '\n' && eol > p) {
-                eol--;
-            }
-        }
-        strncpy(lineBuf, p, eol - p);
-        lineBuf[eol - p] = '\0';
-
-        lines[i] = String(lineBuf);
-        p = eol + 1;
-    }
-    return lines[lineNum];
+int32_t Utils::stringToColor(const String &color) {
+    return stringToColor(color.c_str());
 }
 
-int32_t Utils::stringToColor(String color) {
-    color.toLowerCase();
-    color.replace(" ", "");
-    if (color == "black") {
-        return TFT_BLACK;
-    } else if (color == "navy") {
-        return TFT_NAVY;
-    } else if (color == "darkgreen") {
-        return TFT_DARKGREEN;
-    } else if (color == "darkcyan") {
-        return TFT_DARKCYAN;
-    } else if (color == "maroon") {
-        return TFT_MAROON;
-    } else if (color == "purple") {
-        return TFT_PURPLE;
-    } else if (color == "olive") {
-        return TFT_OLIVE;
-    } else if (color == "lightgrey" || color == "grey") {
-        return TFT_LIGHTGREY;
-    } else if (color == "darkgrey") {
-        return TFT_DARKGREY;
-    } else if (color == "blue") {
-        return TFT_BLUE;
-    } else if (color == "green") {
-        return TFT_GREEN;
-    } else if (color == "cyan") {
-        return TFT_CYAN;
-    } else if (color == "red") {
-        return TFT_RED;
-    } else if (color == "magenta") {
-        return TFT_MAGENTA;
-    } else if (color == "yellow") {
-        return TFT_YELLOW;
-    } else if (color == "white") {
-        return TFT_WHITE;
-    } else if (color == "orange") {
-        return TFT_ORANGE;
-    } else if (color == "greenyellow") {
-        return TFT_GREENYELLOW;
-    } else if (color == "pink") {
-        return TFT_PINK;
-    } else if (color == "brown") {
-        return TFT_BROWN;
-    } else if (color == "gold") {
-        return TFT_GOLD;
-    } else if (color == "silver") {
-        return TFT_SILVER;
-    } else if (color == "skyblue") {
-        return TFT_SKYBLUE;
-    } else if (color == "vilolet") {
-        return TFT_VIOLET;
-    } else {
-        Serial.print("Invalid color: ");
-        Serial.println(color);
-        return TFT_BLACK;
+// Accepts a color name or, in compact encodings like MessagePack, an RGB565 integer
+int32_t Utils::colorFromJson(JsonVariantConst value, int32_t defaultColor) {
+    if (const char *color = value) {
+        return stringToColor(color);
+    }
+    if (value.is<int32_t>()) {
+        return value.as<int32_t>();
     }
+    return defaultColor;
 }
 
-String Utils::formatFloat(float value, int8_t digits)
+FormattedFloat Utils::formatFloat(float value, int8_t digits)
 {
-    char tmp[30] = {};
-    dtostrf(value, 1, digits, tmp);
-    return tmp;
+    FormattedFloat formatted;
+    formatted.format("%.*f", digits, value);
+    return formatted;
 }
 
-int32_t Utils::stringToAlignment(String alignment) {
-    alignment.toLowerCase();
-    if (alignment.indexOf(" ") != -1) {
-        alignment = alignment[0] + alignment.substring(alignment.indexOf(" ") + 1, 1);
-    }
-    alignment.replace(" ", "");
-    if (alignment == "tl") {
-        return TL_DATUM;
-    } else if (alignment == "tc") {
-        return TC_DATUM;
-    } else if (alignment == "tr") {
-        return TR_DATUM;
-    } else if (alignment == "ml") {
-        return ML_DATUM;
-    } else if (alignment == "mc") {
-        return MC_DATUM;
-    } else if (alignment == "mr") {
-        return MR_DATUM;
-    } else if (alignment == "bl") {
-        return BL_DATUM;
-    } else if (alignment == "bc") {
-        return BC_DATUM;
-    } else if (alignment == "br") {
-        return BR_DATUM;
-    } else if (alignment == "cl") {
-        return CL_DATUM;
-    } else if (alignment == "cc") {
-        return CC_DATUM;
-    } else if (alignment == "cr") {
-        return CR_DATUM;
-    } else if (alignment == "bl") {
-        return BL_DATUM;
-    } else if (alignment == "bc") {
-        return BC_DATUM;
-    } else if (alignment == "br") {
-        return BR_DATUM;
-    } else if (alignment == "l") {
-        return L_BASELINE;
-    } else if (alignment == "c") {
-        return C_BASELINE;
-    } else if (alignment == "r") {
-        return R_BASELINE;
-    } else {
-        return TL_DATUM;
+// Accepts datum abbreviations like "tl" or "mc", spelled out words such as
+// "top left" use their initials. A single "l", "c" or "r" is a baseline datum.
+int32_t Utils::stringToAlignment(const char *alignment) {
+    static constexpr auto alignments = makeLookupTable<int32_t>({
+        {"tl", TL_DATUM},
+        {"tc", TC_DATUM},
+        {"tr", TR_DATUM},
+        {"ml", ML_DATUM},
+        {"mc", MC_DATUM},
+        {"mr", MR_DATUM},
+        {"bl", BL_DATUM},
+        {"bc", BC_DATUM},
+        {"br", BR_DATUM},
+        {"cl", CL_DATUM},
+        {"cc", CC_DATUM},
+        {"cr", CR_DATUM},
+        {"l", L_BASELINE},
+        {"c", C_BASELINE},
+        {"r", R_BASELINE},
+    });
+    char initials[3] = {};
+    if (strchr(alignment, ' ') != nullptr) {
+        int count = 0;
+        for (const char *p = alignment; *p != '\0' && count < 2; p++) {
+            if (*p != ' ' && (p == alignment || p[-1] == ' ')) {
+                initials[count++] = *p;
+            }
+        }
+        alignment = initials;
     }
+    return alignments.get(alignment, TL_DATUM);
 }
 
+// A shrinking largest block while free heap stays flat means the heap is fragmenting
+HeapStats Utils::getHeapStats() {
+    static uint32_t minLargestBlock = UINT32_MAX;
+    HeapStats stats;
+    stats.freeHeap = ESP.getFreeHeap();
+    stats.minFreeHeap = ESP.getMinFreeHeap();
+    stats.largestBlock = ESP.getMaxAllocHeap();
+    minLargestBlock = min(minLargestBlock, stats.largestBlock);
+    stats.minLargestBlock = minLargestBlock;
+    stats.fragmentation = stats.freeHeap > 0 ? 100 - stats.largestBlock * 100 / stats.freeHeap : 0;
+    return stats;
+}
+
+void Utils::printHeapStats(const char *tag) {
+    HeapStats stats = getHeapStats();
+    Serial.printf("%s heap: free %u, min free %u, largest block %u, smallest largest block %u, fragmentation %u%%\n", tag, stats.freeHeap, stats.minFreeHeap, stats.largestBlock, stats.minLargestBlock, stats.fragmentation);
+}
@@ -1,10 +1,110 @@
 #include "core/wifiWidget.h"
+#include <Preferences.h>
 #include <WiFi.h>
+#include <bootProfiler.h>
 
-WifiWidget::WifiWidget(ScreenManager& manager) : Widget(manager) {}
+// the cached settings have to fail before the error is shown
+static_assert(WIFI_FAST_CONNECT_TIMEOUT < WIFI_CONNECT_TIMEOUT, "WIFI_FAST_CONNECT_TIMEOUT must be shorter than WIFI_CONNECT_TIMEOUT");
+
+static const uint32_t CONNECT_BOUNDS[] = {250, 500, 1000, 1500, 2000, 3000, 4000, 6000, 8000, 10000};
+
+bool WifiWidget::m_fastPath = false;
+unsigned long WifiWidget::m_connectStart = 0;
+
+WifiWidget::WifiWidget(ScreenManager& manager) : Widget(manager),
+  m_fastConnects("WiFi connect, cached", "ms", CONNECT_BOUNDS, sizeof(CONNECT_BOUNDS) / sizeof(CONNECT_BOUNDS[0])),
+  m_scanConnects("WiFi connect, scan", "ms", CONNECT_BOUNDS, sizeof(CONNECT_BOUNDS) / sizeof(CONNECT_BOUNDS[0])) {}
 
 WifiWidget::~WifiWidget() {}
 
+// Starts associating in the background, called first thing so the display and
+// widgets come up while the access point answers. With the channel and BSSID
+// of the last connection there is no scan, WIFI_REUSE_IP_LEASE skips DHCP too.
+void WifiWidget::connect() {
+  m_connectStart = millis();
+  Cache cache;
+  m_fastPath = loadCache(cache);
+  if (m_fastPath) {
+#ifdef WIFI_REUSE_IP_LEASE
+    if (cache.ip != 0) {
+      WiFi.config(IPAddress(cache.ip), IPAddress(cache.gateway), IPAddress(cache.subnet), IPAddress(cache.dns));
+    }
+#endif
+    WiFi.begin(WIFI_SSID, WIFI_PASS, cache.channel, cache.bssid);
+    Serial.printf("Connecting to WiFi on channel %u..\n", cache.channel);
+  } else {
+    WiFi.begin(WIFI_SSID, WIFI_PASS);
+    Serial.println("Connecting to WiFi..");
+  }
+}
+
+bool WifiWidget::loadCache(Cache &cache) {
+  Preferences preferences;
+  if (!preferences.begin(WIFI_PREFERENCES, true)) {
+    return false;
+  }
+  bool loaded = preferences.getBytesLength("cache") == sizeof(cache) && preferences.getBytes("cache", &cache, sizeof(cache)) == sizeof(cache);
+  preferences.end();
+  return loaded && cache.ssidHash == ssidHash() && cache.channel != 0;
+}
+
+uint32_t WifiWidget::ssidHash() {
+  uint32_t hash = 2166136261u;
+  for (const char *c = WIFI_SSID; *c != '\0'; c++) {
+    hash = (hash ^ (uint8_t)*c) * 16777619u;
+  }
+  return hash;
+}
+
+// The access point moved or the address was taken, start over the slow way
+void WifiWidget::fallBackToScan() {
+  Serial.println();
+  Serial.printf("Cached WiFi settings failed after %lu ms, scanning\n", millis() - m_connectStart);
+  m_fastPath = false;
+  WiFi.disconnect();
+#ifdef WIFI_REUSE_IP_LEASE
+  // all zero turns DHCP back on
+  WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));
+#endif
+  WiFi.begin(WIFI_SSID, WIFI_PASS);
+  // the scan gets the full WIFI_CONNECT_TIMEOUT of its own
+  m_connectStart = millis();
+  m_connectionFailed = false;
+  m_hasDisplayedError = false;
+}
+
+// Records how long it took on which path and remembers where we ended up
+void WifiWidget::onConnected() {
+  unsigned long elapsed = millis() - m_connectStart;
+  Cache cache = {ssidHash(), {}, (uint8_t)WiFi.channel(), (uint32_t)WiFi.localIP(), (uint32_t)WiFi.gatewayIP(), (uint32_t)WiFi.subnetMask(), (uint32_t)WiFi.dnsIP()};
+  memcpy(cache.bssid, WiFi.BSSID(), sizeof(cache.bssid));
+
+  Preferences preferences;
+  if (!preferences.begin(WIFI_PREFERENCES, false)) {
+    Serial.println("WiFi cache: NVS unavailable");
+    return;
+  }
+  Cache previous;
+  if (preferences.getBytes("cache", &previous, sizeof(previous)) != sizeof(previous) || memcmp(&previous, &cache, sizeof(cache)) != 0) {
+    preferences.putBytes("cache", &cache, sizeof(cache));
+  }
+  // distributions over all boots, one sample each
+  m_fastConnects.load(preferences, "fast");
+  m_scanConnects.load(preferences, "scan");
+  if (m_fastPath) {
+    m_fastConnects.add(elapsed);
+    m_fastConnects.save(preferences, "fast");
+  } else {
+    m_scanConnects.add(elapsed);
+    m_scanConnects.save(preferences, "scan");
+  }
+  preferences.end();
+
+  Serial.printf("WiFi connected in %lu ms on channel %u (%s)\n", elapsed, cache.channel, m_fastPath ? "cached" : "scan");
+  m_fastConnects.print();
+  m_scanConnects.print();
+}
+
 void WifiWidget::setup() {
   TFT_eSPI &display = m_manager.getDisplay();
   m_manager.selectAllScreens();
@@ -21,30 +121,28 @@ void WifiWidget::setup() {
   display.drawCentreString("WiFi..", 120, 100, 1);
   display.drawCentreString(WIFI_SSID, 120, 130, 1);
 
-  // Serial.println("Connecting to WiFi..");
-
-  WiFi.begin(WIFI_SSID, WIFI_PASS);
-
-  Serial.println("Connecting to WiFi..");
-
-
-
 }
 
 void WifiWidget::update(bool force) {
   //force is currently an unhandled due to not knowing what behavior it would change
 
 	if(WiFi.status() == WL_CONNECTED) {
+		if (!m_isConnected) {
+			BootProfiler::mark("wifi connected");
+			onConnected();
+		}
 		m_isConnected = true;
 		m_connectionString = "Connected";
 	} else {
-		m_connectionTimer += 500;
+		if (m_fastPath && millis() - m_connectStart > WIFI_FAST_CONNECT_TIMEOUT) {
+			fallBackToScan();
+		}
 		m_dotsString += ".";
     Serial.print(".");
 		if(m_dotsString.length() > 3) {
 			m_dotsString = "";
 		}
-		if(m_connectionTimer > m_connectionTimeout) {
+		if(millis() - m_connectStart > WIFI_CONNECT_TIMEOUT) {
 			m_connectionFailed = true;
 			connectionTimedOut();
 		}
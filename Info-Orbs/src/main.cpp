@@ -4,9 +4,15 @@
 #include "widgets/clockWidget.h"
 #include "widgets/weatherWidget.h"
 #include "widgets/webDataWidget.h"
+#include "widgets/mqttDataWidget.h"
+#include "widgets/worldClockWidget.h"
 #include <Arduino.h>
 #include <Button.h>
+#include <bootProfiler.h>
 #include <globalTime.h>
+#include <heapAccounting.h>
+#include <imageCache.h>
+#include <memoryGovernor.h>
 #include <config.h>
 #include <widgets/stockWidget.h>
 
@@ -42,18 +48,29 @@ ScreenManager* sm;
 WidgetSet* widgetSet;
 
 void setup() {
-
-  buttonLeft.begin();
-  buttonOK.begin();
-  buttonRight.begin();
+  HeapAccounting::begin();
+  BootProfiler::mark("setup");
 
   Serial.begin(115200);
   Serial.println();
   Serial.println("Starting up...");
 
+  // association takes seconds, everything below overlaps with it
+  Serial.println("Connecting to: " + String(WIFI_SSID));
+  {
+    HeapTagGuard tag("wifi");
+    WifiWidget::connect();
+  }
+  BootProfiler::mark("wifi started");
+
+  buttonLeft.begin();
+  buttonOK.begin();
+  buttonRight.begin();
+
   sm = new ScreenManager(tft);
   sm->selectAllScreens();
   sm->getDisplay().fillScreen(TFT_WHITE);
+  BootProfiler::mark("first pixel");
   sm->reset();
   widgetSet = new WidgetSet(sm);
 
@@ -71,12 +88,18 @@ void setup() {
 #endif
 
   pinMode(BUSY_PIN, OUTPUT);
-  Serial.println("Connecting to: " + String(WIFI_SSID));
-
-  wifiWidget = new WifiWidget(*sm);
-  wifiWidget->setup();
 
-  globalTime = GlobalTime::getInstance();
+  {
+    HeapTagGuard tag("wifi");
+    wifiWidget = new WifiWidget(*sm);
+    wifiWidget->setup();
+  }
+  BootProfiler::mark("wifi screen");
+  {
+    // SNTP is set up before the link, its first request goes out as soon as there is one
+    HeapTagGuard tag("time");
+    globalTime = GlobalTime::getInstance();
+  }
 
   widgetSet->add(new ClockWidget(*sm));
   widgetSet->add(new StockWidget(*sm));
@@ -87,10 +110,31 @@ void setup() {
 #ifdef WEB_DATA_STOCK_WIDGET_URL
   widgetSet->add(new WebDataWidget(*sm, WEB_DATA_STOCK_WIDGET_URL));
 #endif
+#ifdef MQTT_BROKER_HOST
+  widgetSet->add(new MqttDataWidget(*sm, MQTT_BROKER_HOST, MQTT_TOPICS));
+#endif
+#ifdef WORLD_CLOCK_CITIES
+  widgetSet->add(new WorldClockWidget(*sm, WORLD_CLOCK_CITIES));
+#endif
+  BootProfiler::mark("widgets set up");
+
+#if defined(WEB_DATA_WIDGET_URL) || defined(WEB_DATA_STOCK_WIDGET_URL) || defined(MQTT_BROKER_HOST)
+  {
+    // mount and index cached images now rather than on the first WebData draw
+    HeapTagGuard tag("images");
+    ImageCache::getInstance()->begin();
+  }
+  BootProfiler::mark("image cache");
+#endif
+  // everything reserved up front is allocated now, see the budget in memoryGovernor.h
+  Utils::printHeapStats("setup");
 }
 
 void loop() {
+  HeapAccounting::update();
+  MemoryGovernor::getInstance()->update();
   if (wifiWidget->isConnected() == false) {
+    HeapTagGuard tag("wifi");
     wifiWidget->update();
     wifiWidget->draw();
     widgetSet->setClearScreensOnDrawCurrent(); //clear screen after wifiWidget
@@ -99,7 +143,10 @@ void loop() {
     if (!widgetSet->initialUpdateDone()) {
       widgetSet->initializeAllWidgetsData();
     }
-    globalTime->updateTime();
+    {
+      HeapTagGuard tag("time");
+      globalTime->updateTime();
+    }
 
     if (buttonLeft.pressed()) {
       Serial.println("Left button pressed");
@@ -116,5 +163,10 @@ void loop() {
 
     widgetSet->updateCurrent();
     widgetSet->drawCurrent();
+    widgetSet->prefetchNext();
+#if defined(WEB_DATA_WIDGET_URL) || defined(WEB_DATA_STOCK_WIDGET_URL) || defined(MQTT_BROKER_HOST)
+    // images requested while parsing are downloaded here, one per loop
+    ImageCache::getInstance()->update();
+#endif
   }
 }
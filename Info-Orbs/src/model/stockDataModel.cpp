@@ -5,14 +5,12 @@
 StockDataModel::StockDataModel() {
 }
 
-StockDataModel &StockDataModel::setSymbol(String symbol) {
-    if (m_symbol != symbol) {
-        m_symbol = String(symbol);
-        // this is not a regular data field so do not mark changed when set
-    }
+StockDataModel &StockDataModel::setSymbol(StringView symbol) {
+    // this is not a regular data field so do not mark changed when set
+    m_symbol.set(symbol, "Stock symbol");
     return *this;
 }
-String StockDataModel::getSymbol() {
+const FixedString<STOCK_SYMBOL_LENGTH> &StockDataModel::getSymbol() {
     return m_symbol;
 }
 StockDataModel &StockDataModel::setCurrentPrice(float currentPrice) {
@@ -25,7 +23,7 @@ StockDataModel &StockDataModel::setCurrentPrice(float currentPrice) {
 float StockDataModel::getCurrentPrice() {
     return m_currentPrice;
 }
-String StockDataModel::getCurrentPrice(int8_t digits) {
+FormattedFloat StockDataModel::getCurrentPrice(int8_t digits) {
     return Utils::formatFloat(m_currentPrice, digits);
 }
 
@@ -41,7 +39,7 @@ float StockDataModel::getVolume() {
     return m_volume;
 }
 
-String StockDataModel::getVolume(int8_t digits) {
+FormattedFloat StockDataModel::getVolume(int8_t digits) {
     return Utils::formatFloat(m_volume, digits);
 }
 
@@ -55,7 +53,7 @@ StockDataModel &StockDataModel::setPriceChange(float priceChange) {
 float StockDataModel::getPriceChange() {
     return m_priceChange;
 }
-String StockDataModel::getPriceChange(int8_t digits) {
+FormattedFloat StockDataModel::getPriceChange(int8_t digits) {
     return Utils::formatFloat(m_priceChange, digits);
 }
 
@@ -70,7 +68,7 @@ float StockDataModel::getPercentChange() {
     return m_percentChange;
 }
 
-String StockDataModel::getPercentChange(int8_t digits) {
+FormattedFloat StockDataModel::getPercentChange(int8_t digits) {
     return Utils::formatFloat(m_percentChange*100, digits);
 }
 
@@ -4,39 +4,36 @@
 WeatherDataModel::WeatherDataModel() {
 }
 
-WeatherDataModel &WeatherDataModel::setCityName(String city) {
-    if (m_cityName != city) {
-        m_cityName = city;
+WeatherDataModel &WeatherDataModel::setCityName(StringView city) {
+    if (m_cityName.set(city, "Weather city")) {
         m_changed = true;
     }
     return *this;
 }
 
-String WeatherDataModel::getCityName() {
+const FixedString<WEATHER_CITY_LENGTH> &WeatherDataModel::getCityName() {
     return m_cityName;
 }
 
-WeatherDataModel &WeatherDataModel::setCurrentText(String text) {
-    if (m_currentWeatherText != text) {
-        m_currentWeatherText = text;
+WeatherDataModel &WeatherDataModel::setCurrentText(StringView text) {
+    if (m_currentWeatherText.set(text, "Weather description")) {
         m_changed = true;
     }
     return *this;
 }
 
-String WeatherDataModel::getCurrentText() {
+const FixedString<WEATHER_TEXT_LENGTH> &WeatherDataModel::getCurrentText() {
     return m_currentWeatherText;
 }
 
-WeatherDataModel &WeatherDataModel::setCurrentIcon(String icon) {
-    if (m_currentWeatherIcon != icon) {
-        m_currentWeatherIcon = icon;
+WeatherDataModel &WeatherDataModel::setCurrentIcon(StringView icon) {
+    if (m_currentWeatherIcon.set(icon, "Weather icon")) {
         m_changed = true;
     }
     return *this;
 }
 
-String WeatherDataModel::getCurrentIcon() {
+const WeatherIconName &WeatherDataModel::getCurrentIcon() {
     return m_currentWeatherIcon;
 }
 
@@ -52,7 +49,7 @@ float WeatherDataModel::getCurrentTemperature() {
     return m_currentWeatherDeg;
 }
 
-String WeatherDataModel::getCurrentTemperature(int8_t digits) {
+FormattedFloat WeatherDataModel::getCurrentTemperature(int8_t digits) {
     return Utils::formatFloat(m_currentWeatherDeg, digits);
 }
 
@@ -68,7 +65,7 @@ float WeatherDataModel::getTodayHigh() {
     return m_todayHigh;
 }
 
-String WeatherDataModel::getTodayHigh(int8_t digits) {
+FormattedFloat WeatherDataModel::getTodayHigh(int8_t digits) {
     return Utils::formatFloat(m_todayHigh, digits);
 }
 
@@ -84,32 +81,32 @@ float WeatherDataModel::getTodayLow() {
     return m_todayLow;
 }
 
-String WeatherDataModel::getTodayLow(int8_t digits) {
+FormattedFloat WeatherDataModel::getTodayLow(int8_t digits) {
     return Utils::formatFloat(m_todayLow, digits);
 }
 
-WeatherDataModel &WeatherDataModel::setDaysIcons(String *icons) {
+WeatherDataModel &WeatherDataModel::setDaysIcons(StringView *icons) {
     for (int i; i < 3; i++) {
         setDayIcon(i, icons[i]);
     }
     return *this;
 }
 
-String &WeatherDataModel::getDaysIcons() {
+const WeatherIconName &WeatherDataModel::getDaysIcons() {
     return *m_daysIcons;
 }
 
-WeatherDataModel &WeatherDataModel::setDayIcon(int num, String icon) {
-    if (num < 3 && m_daysIcons[num] != icon) {
-        m_daysIcons[num] = icon;
+WeatherDataModel &WeatherDataModel::setDayIcon(int num, StringView icon) {
+    if (num < 3 && m_daysIcons[num].set(icon, "Weather day icon")) {
         m_changed = true;
     }
     return *this;
 }
 
-String WeatherDataModel::getDayIcon(int num) {
+const WeatherIconName &WeatherDataModel::getDayIcon(int num) {
+    static const WeatherIconName none;
     if (num >= 3) {
-        return "";
+        return none;
     }
     return m_daysIcons[num];
 }
@@ -140,9 +137,9 @@ float WeatherDataModel::getDayLow(int num) {
     return m_daysLow[num];
 }
 
-String WeatherDataModel::getDayLow(int8_t num, int8_t digits) {
+FormattedFloat WeatherDataModel::getDayLow(int8_t num, int8_t digits) {
     if (m_daysLow[num] == NaN) {
-        return "";
+        return FormattedFloat();
     }
     return Utils::formatFloat(m_daysLow[num], digits);
 }
@@ -165,9 +162,9 @@ float WeatherDataModel::getDayHigh(int num) {
     return m_daysHigh[num];
 }
 
-String WeatherDataModel::getDayHigh(int8_t num, int8_t digits) {
+FormattedFloat WeatherDataModel::getDayHigh(int8_t num, int8_t digits) {
     if (m_daysHigh[num] == NaN) {
-        return "";
+        return FormattedFloat();
     }
     return Utils::formatFloat(m_daysHigh[num], digits);
 }
@@ -1,8 +1,44 @@
 #include "model/webDataElement.h"
 
-bool WebDataElement::isChanged() {
-    return m_changed;
+// Compares everything that ends up on screen, ignores id and bookkeeping
+bool WebDataElement::drawsSameAs(const WebDataElement& other) const {
+    return type == other.type && x == other.x && y == other.y && v[0] == other.v[0] && v[1] == other.v[1] && v[2] == other.v[2] && v[3] == other.v[3] &&
+           color == other.color && background == other.background && text == other.text && font == other.font && size == other.size &&
+           datum == other.datum && (flags & ~WEB_DATA_ELEMENT_CHANGED) == (other.flags & ~WEB_DATA_ELEMENT_CHANGED);
 }
-void WebDataElement::setChangedStatus(bool changed) {
-    m_changed = changed;
+
+// Places a w x h text box relative to x/y the way TFT_eSPI applies the datum
+WebDataBounds WebDataBounds::fromText(int32_t x, int32_t y, int32_t w, int32_t h, int32_t datum) {
+    WebDataBounds bounds;
+    bounds.w = w;
+    bounds.h = h;
+    int32_t column = datum >= L_BASELINE ? datum - L_BASELINE : datum % 3;
+    bounds.x = x - (column == 1 ? w / 2 : column == 2 ? w : 0);
+    if (datum >= L_BASELINE) {
+        // baseline datums leave the descenders below y, cover them too
+        bounds.y = y - h;
+        bounds.h = h + h / 4;
+    } else {
+        int32_t row = datum / 3;
+        bounds.y = y - (row == 1 ? h / 2 : row == 2 ? h : 0);
+    }
+    return bounds;
+}
+
+bool WebDataBounds::isEmpty() const {
+    return w <= 0 || h <= 0;
+}
+
+bool WebDataBounds::intersects(const WebDataBounds& other) const {
+    return !isEmpty() && !other.isEmpty() && x < other.x + other.w && other.x < x + w && y < other.y + other.h && other.y < y + h;
+}
+
+// Bounds of the pixels between two corners, inclusive
+WebDataBounds WebDataBounds::fromPoints(int32_t x1, int32_t y1, int32_t x2, int32_t y2) {
+    WebDataBounds bounds;
+    bounds.x = min(x1, x2);
+    bounds.y = min(y1, y2);
+    bounds.w = abs(x2 - x1) + 1;
+    bounds.h = abs(y2 - y1) + 1;
+    return bounds;
 }
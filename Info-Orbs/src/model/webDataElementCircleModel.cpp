@@ -1,87 +1,26 @@
 #include "model/webDataElementCircleModel.h"
 
-int32_t WebDataElementCircleModel::getX() {
-    return m_x;
-}
-
-void WebDataElementCircleModel::setX(int32_t x) {
-    if (m_x != x) {
-        m_x = x;
-        m_changed = true;
-    }
-}
-
-int32_t WebDataElementCircleModel::getY() {
-    return m_y;
-}
-
-void WebDataElementCircleModel::setY(int32_t y) {
-    if (m_y != y) {
-        m_y = y;
-        m_changed = true;
+// Absent fields keep what the record passed in holds
+const char *WebDataElementCircleModel::parseData(const JsonObject &doc, WebDataElement &element) {
+    element.x = doc["x"] | element.x;
+    element.y = doc["y"] | element.y;
+    element.v[0] = doc["radius"] | element.v[0];
+    if (!doc["filled"].isNull()) {
+        element.flags = doc["filled"].as<bool>() ? element.flags | WEB_DATA_ELEMENT_FILLED : element.flags & ~WEB_DATA_ELEMENT_FILLED;
     }
+    element.color = Utils::colorFromJson(doc["color"], element.color);
+    return nullptr;
 }
 
-int32_t WebDataElementCircleModel::getRadius() {
-    return m_radius;
-}
-
-void WebDataElementCircleModel::setRadius(int32_t radius) {
-    if (m_radius != radius) {
-        m_radius = radius;
-        m_changed = true;
-    }
-}
-
-bool WebDataElementCircleModel::getFilled() {
-    return m_filled;
-}
-
-void WebDataElementCircleModel::setFilled(bool filled) {
-    if (m_filled != filled) {
-        m_filled = filled;
-        m_changed = true;
-    }
-}
-void WebDataElementCircleModel::setColor(int32_t color) {
-    if (m_color != color) {
-        m_color = color;
-        m_changed = true;
-    }
-}
-
-void WebDataElementCircleModel::setColor(String color) {
-    setColor(Utils::stringToColor(color));
-}
-
-int32_t WebDataElementCircleModel::getColor() {
-    return m_color;
-}
-
-void WebDataElementCircleModel::parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground) {
-    if (doc["x"].is<int32_t>()) {
-        setX(doc["x"].as<int32_t>());
-    }
-    if (doc["y"].is<int32_t>()) {
-        setY(doc["y"].as<int32_t>());
-    }
-    if (doc["radius"].is<int32_t>()) {
-        setRadius(doc["radius"].as<int32_t>());
-    }
-    if (doc["filled"].is<int32_t>()) {
-        setFilled(doc["filled"].as<bool>());
-    }
-    if (const char* color = doc["color"]) {
-        setColor(color);
+void WebDataElementCircleModel::draw(const WebDataElement &element, const char *text, TFT_eSPI &display) {
+    if (element.flags & WEB_DATA_ELEMENT_FILLED) {
+        display.fillCircle(element.x, element.y, element.v[0], element.color);
     } else {
-        setColor(defaultColor);
+        display.drawCircle(element.x, element.y, element.v[0], element.color);
     }
 }
 
-void WebDataElementCircleModel::draw(TFT_eSPI& display) {
-    if (getFilled()) {
-        display.fillCircle(getX(), getY(), getRadius(), getColor());
-    } else {
-        display.drawCircle(getX(), getY(), getRadius(), getColor());
-    }
+WebDataBounds WebDataElementCircleModel::getBounds(const WebDataElement &element, const char *text, TFT_eSPI &display) {
+    int32_t radius = element.v[0];
+    return WebDataBounds::fromPoints(element.x - radius, element.y - radius, element.x + radius, element.y + radius);
 }
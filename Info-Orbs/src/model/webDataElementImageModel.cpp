@@ -1,135 +1,87 @@
 #include "model/webDataElementImageModel.h"
 
-#include <HTTPClient.h>
 #include <LittleFS.h>
-#include <WiFi.h>
-
-int32_t WebDataElementImageModel::getX() {
-    return m_x;
-}
-
-void WebDataElementImageModel::setX(int32_t x) {
-    if (m_x != x) {
-        m_x = x;
-        m_changed = true;
+#include <TJpg_Decoder.h>
+#include <imageCache.h>
+
+// Absent fields keep what the record passed in holds. "image" is the
+// URL, "width"/"height" give the box the image is scaled down into and the
+// size of "format": "rgb565" images (big-endian, as the panel takes them).
+// v[2]/v[3] hold the JPEG size once the image is cached.
+const char *WebDataElementImageModel::parseData(const JsonObject &doc, WebDataElement &element) {
+    element.x = doc["x"] | element.x;
+    element.y = doc["y"] | element.y;
+    element.v[0] = doc["width"] | element.v[0];
+    element.v[1] = doc["height"] | element.v[1];
+    if (const char *format = doc["format"]) {
+        element.flags = strcmp(format, "rgb565") == 0 ? element.flags | WEB_DATA_ELEMENT_RAW : element.flags & ~WEB_DATA_ELEMENT_RAW;
     }
-}
-
-int32_t WebDataElementImageModel::getY() {
-    return m_y;
-}
-
-void WebDataElementImageModel::setY(int32_t y) {
-    if (m_y != y) {
-        m_y = y;
-        m_changed = true;
+    const char *url = doc["image"];
+    if (url != nullptr && url[0] != '\0') {
+        refresh(element, url);
+        // queued, the widget redraws the element once the cache has it
+        ImageCache::getInstance()->request(url, (element.flags & WEB_DATA_ELEMENT_RAW) ? element.v[0] * element.v[1] * 2 : 0);
     }
+    return url;
 }
 
-String WebDataElementImageModel::getImage() {
-    return m_image;
+// Picks up the JPEG size from the cache index after the image arrived or changed
+void WebDataElementImageModel::refresh(WebDataElement &element, const char *text) {
+    uint16_t w = 0;
+    uint16_t h = 0;
+    ImageCache::getInstance()->lookup(text, &w, &h);
+    element.v[2] = w;
+    element.v[3] = h;
 }
 
-void WebDataElementImageModel::setImage(String image) {
-    if (m_image != image) {
-        m_image = image;
-        m_changed = true;
+void WebDataElementImageModel::draw(const WebDataElement &element, const char *text, TFT_eSPI &display) {
+    String path = ImageCache::getInstance()->lookup(text);
+    if (path == "") {
+        return;
     }
+    if (element.flags & WEB_DATA_ELEMENT_RAW) {
+        File file = LittleFS.open(path, "r");
+        if (!file || element.v[0] <= 0 || element.v[0] > display.width()) {
+            return;
+        }
+        uint16_t line[element.v[0]];
+        for (int row = 0; row < element.v[1]; row++) {
+            if (file.read((uint8_t *)line, sizeof(line)) != sizeof(line)) {
+                break;
+            }
+            display.pushImage(element.x, element.y + row, element.v[0], 1, line);
+        }
+        file.close();
+        return;
+    }
+    TJpgDec.setJpgScale(getScale(element));
+    TJpgDec.drawFsJpg(element.x, element.y, path, LittleFS);
 }
 
-void WebDataElementImageModel::parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground) {
-    if (doc["x"].is<int32_t>()) {
-        setX(doc["x"].as<int32_t>());
-    }
-    if (doc["y"].is<int32_t>()) {
-        setY(doc["y"].as<int32_t>());
+WebDataBounds WebDataElementImageModel::getBounds(const WebDataElement &element, const char *text, TFT_eSPI &display) {
+    WebDataBounds bounds;
+    bounds.x = element.x;
+    bounds.y = element.y;
+    if (element.v[0] > 0 && element.v[1] > 0) {
+        bounds.w = element.v[0];
+        bounds.h = element.v[1];
+        return bounds;
     }
-    if (const char* image = doc["image"]) {
-        setImage(image);
+    if (!(element.flags & WEB_DATA_ELEMENT_RAW)) {
+        uint8_t scale = getScale(element);
+        bounds.w = element.v[2] / scale;
+        bounds.h = element.v[3] / scale;
     }
-    // if (const char* imageUrl = doc["imageUrl"]) {
-    //     setImageUrl(imageUrl);
-    // }
-    // if (const char* imageBytes = doc["imageBytes"]) {
-    //     setImageBytes(imageBytes);
-    // }
+    return bounds;
 }
 
-void WebDataElementImageModel::draw(TFT_eSPI& display) {
-    // TODO implement displaying an image
-    //  display.drawImage(getImage(), getX(), getY());
-}
-
-// Fetch a file from the URL given and save it in LittleFS
-// Return 1 if a web fetch was needed or 0 if file already exists
-bool getFile(String url, String filename) {
-    // If it exists then no need to fetch it
-    if (LittleFS.exists(filename) == true) {
-        Serial.println("Found " + filename);
-        return 0;
-    }
-
-    Serial.println("Downloading " + filename + " from " + url);
-
-    // Check WiFi connection
-    if ((WiFi.status() == WL_CONNECTED)) {
-        Serial.print("[HTTP] begin...\n");
-
-        HTTPClient http;
-        // Configure server and url
-        http.begin(url);
-
-        Serial.print("[HTTP] GET...\n");
-        // Start connection and send HTTP header
-        int httpCode = http.GET();
-        if (httpCode == 200) {
-            fs::File f = LittleFS.open(filename, "w+");
-            if (!f) {
-                Serial.println("file open failed");
-                return 0;
-            }
-            // HTTP header has been send and Server response header has been handled
-            Serial.printf("[HTTP] GET... code: %d\n", httpCode);
-
-            // File found at server
-            if (httpCode == HTTP_CODE_OK) {
-                // Get length of document (is -1 when Server sends no Content-Length header)
-                int total = http.getSize();
-                int len = total;
-
-                // Create buffer for read
-                uint8_t buff[128] = {0};
-
-                // Get tcp stream
-                WiFiClient* stream = http.getStreamPtr();
-
-                // Read all data from server
-                while (http.connected() && (len > 0 || len == -1)) {
-                    // Get available data size
-                    size_t size = stream->available();
-
-                    if (size) {
-                        // Read up to 128 bytes
-                        int c = stream->readBytes(buff, ((size > sizeof(buff)) ? sizeof(buff) : size));
-
-                        // Write it to file
-                        f.write(buff, c);
-
-                        // Calculate remaining bytes
-                        if (len > 0) {
-                            len -= c;
-                        }
-                    }
-                    yield();
-                }
-                Serial.println();
-                Serial.print("[HTTP] connection closed or file end.\n");
-            }
-            f.close();
-        } else {
-            Serial.printf("[HTTP] GET... failed, error: %s\n", http.errorToString(httpCode).c_str());
-        }
-        http.end();
+// Smallest TJpgDec scale (1, 2, 4 or 8) that fits the JPEG into width/height
+uint8_t WebDataElementImageModel::getScale(const WebDataElement &element) {
+    int w = element.v[2];
+    int h = element.v[3];
+    uint8_t scale = 1;
+    while (scale < 8 && ((element.v[0] > 0 && w / scale > element.v[0]) || (element.v[1] > 0 && h / scale > element.v[1]))) {
+        scale *= 2;
     }
-    return 1;  // File was fetched from web
+    return scale;
 }
@@ -9,79 +9,135 @@
 #include "model/webDataElementTextModel.h"
 #include "model/webDataElementTriangleModel.h"
 
-void WebDataElementModel::setType(const String& type) {
-    if (type == "text") {
-        m_type = TEXT;
-    } else if (type == "rectangle") {
-        m_type = RECTANGLE;
-    } else if (type == "character") {
-        m_type = CHARACTER;
-    } else if (type == "triangle") {
-        m_type = TRIANGLE;
-    } else if (type == "circle") {
-        m_type = CIRCLE;
-    } else if (type == "arc") {
-        m_type = ARC;
-    } else if (type == "line") {
-        m_type = LINE;
-    } else if (type == "image") {
-        m_type = IMAGE;
-    } else {
-        m_type = OTHER;
-    }
-}
+#include <lookupTable.h>
 
-WebDataElementModelTypes WebDataElementModel::getType() {
-    return m_type;
+WebDataElementModelTypes WebDataElementModel::parseTypeName(const char* type) {
+    static constexpr auto types = makeLookupTable<WebDataElementModelTypes>({
+        {"text", TEXT},
+        {"character", CHARACTER},
+        {"line", LINE},
+        {"rectangle", RECTANGLE},
+        {"triangle", TRIANGLE},
+        {"circle", CIRCLE},
+        {"arc", ARC},
+        {"image", IMAGE},
+    });
+    return types.get(type, OTHER);
 }
 
-bool WebDataElementModel::isChanged() {
-    return m_changed;
-}
-void WebDataElementModel::setChangedStatus(bool changed) {
-    m_changed = changed;
+// Accepts the type name or its numeric wire encoding
+WebDataElementModelTypes WebDataElementModel::parseType(JsonVariantConst type) {
+    if (const char* name = type.as<const char*>()) {
+        return parseTypeName(name);
+    }
+    if (type.is<int>()) {
+        int value = type.as<int>();
+        if (value >= 0 && value < OTHER) {
+            return (WebDataElementModelTypes)value;
+        }
+    }
+    return OTHER;
 }
 
-void WebDataElementModel::parseData(JsonObject doc, int32_t defaultColor, int32_t defaultBackground) {
-    delete m_element;
-    m_element = nullptr;
+// FNV-1a of the id as text so "7" and 7 name the same element, 0 is kept for "no id"
+uint32_t WebDataElementModel::parseId(JsonVariantConst id) {
+    if (id.isNull()) {
+        return 0;
+    }
+    const char *text = id.as<const char *>();
+    char number[24];
+    if (text == nullptr) {
+        serializeJson(id, number, sizeof(number));
+        text = number;
+    }
+    uint32_t hash = 2166136261u;
+    for (; *text != '\0'; text++) {
+        hash = (hash ^ (uint8_t)*text) * 16777619u;
+    }
+    return hash != 0 ? hash : 1;
+}
 
-    if (const char* type = doc["type"]) {
-        setType(type);
-        switch (getType()) {
-            case TEXT:
-                m_element = new WebDataElementTextModel();
-                break;
-            case CHARACTER:
-                m_element = new WebDataElementCharacterModel();
-                break;
-            case LINE:
-                m_element = new WebDataElementLineModel();
-                break;
-            case RECTANGLE:
-                m_element = new WebDataElementRectangleModel();
-                break;
-            case TRIANGLE:
-                m_element = new WebDataElementTriangleModel();
-                break;
-            case CIRCLE:
-                m_element = new WebDataElementCircleModel();
-                break;
-            case ARC:
-                m_element = new WebDataElementArcModel();
-                break;
-            case IMAGE:
-                m_element = new WebDataElementImageModel();
-                break;
-        }
+// Updates the record with the fields doc has and returns the text the
+// element draws, if any, for the caller to intern
+const char* WebDataElementModel::parseData(const JsonObject& doc, WebDataElement& element) {
+    if (!doc["id"].isNull()) {
+        element.id = parseId(doc["id"]);
+    }
+    if (!doc["type"].isNull()) {
+        element.type = parseType(doc["type"]);
     }
-    if (m_element != nullptr) {
-        m_element->parseData(doc, defaultColor, defaultBackground);
+    switch (element.type) {
+        case TEXT:
+            return WebDataElementTextModel::parseData(doc, element);
+        case CHARACTER:
+            return WebDataElementCharacterModel::parseData(doc, element);
+        case LINE:
+            return WebDataElementLineModel::parseData(doc, element);
+        case RECTANGLE:
+            return WebDataElementRectangleModel::parseData(doc, element);
+        case TRIANGLE:
+            return WebDataElementTriangleModel::parseData(doc, element);
+        case CIRCLE:
+            return WebDataElementCircleModel::parseData(doc, element);
+        case ARC:
+            return WebDataElementArcModel::parseData(doc, element);
+        case IMAGE:
+            return WebDataElementImageModel::parseData(doc, element);
+        default:
+            return nullptr;
+    }
+}
+
+void WebDataElementModel::draw(const WebDataElement& element, const char* text, TFT_eSPI& display) {
+    switch (element.type) {
+        case TEXT:
+            WebDataElementTextModel::draw(element, text, display);
+            break;
+        case CHARACTER:
+            WebDataElementCharacterModel::draw(element, text, display);
+            break;
+        case LINE:
+            WebDataElementLineModel::draw(element, text, display);
+            break;
+        case RECTANGLE:
+            WebDataElementRectangleModel::draw(element, text, display);
+            break;
+        case TRIANGLE:
+            WebDataElementTriangleModel::draw(element, text, display);
+            break;
+        case CIRCLE:
+            WebDataElementCircleModel::draw(element, text, display);
+            break;
+        case ARC:
+            WebDataElementArcModel::draw(element, text, display);
+            break;
+        case IMAGE:
+            WebDataElementImageModel::draw(element, text, display);
+            break;
+        default:
+            break;
     }
 }
 
-void WebDataElementModel::draw(TFT_eSPI& display) {
-    if (m_element != nullptr && getType() != OTHER) {
-        m_element->draw(display);
+WebDataBounds WebDataElementModel::getBounds(const WebDataElement& element, const char* text, TFT_eSPI& display) {
+    switch (element.type) {
+        case TEXT:
+            return WebDataElementTextModel::getBounds(element, text, display);
+        case CHARACTER:
+            return WebDataElementCharacterModel::getBounds(element, text, display);
+        case LINE:
+            return WebDataElementLineModel::getBounds(element, text, display);
+        case RECTANGLE:
+            return WebDataElementRectangleModel::getBounds(element, text, display);
+        case TRIANGLE:
+            return WebDataElementTriangleModel::getBounds(element, text, display);
+        case CIRCLE:
+            return WebDataElementCircleModel::getBounds(element, text, display);
+        case ARC:
+            return WebDataElementArcModel::getBounds(element, text, display);
+        case IMAGE:
+            return WebDataElementImageModel::getBounds(element, text, display);
+        default:
+            return WebDataBounds();
     }
 }
@@ -0,0 +1,54 @@
+#include "model/webDataElementPool.h"
+
+WebDataElementPool::WebDataElementPool() {
+    for (int i = WEB_DATA_POOL_SLOTS - 1; i >= 0; i--) {
+        m_free[m_freeCount++] = i;
+    }
+}
+
+// Returns a slot holding a default record, -1 when every slot is in use
+int32_t WebDataElementPool::acquire() {
+    if (m_freeCount == 0) {
+        m_stats.exhausted++;
+        return -1;
+    }
+    uint16_t slot = m_free[--m_freeCount];
+    m_elements[slot] = WebDataElement();
+    m_stats.acquired++;
+    m_stats.used++;
+    if (m_stats.used > m_stats.peak) {
+        m_stats.peak = m_stats.used;
+    }
+    return slot;
+}
+
+void WebDataElementPool::release(uint16_t slot) {
+    m_free[m_freeCount++] = slot;
+    m_stats.released++;
+    m_stats.used--;
+}
+
+WebDataElement &WebDataElementPool::get(uint16_t slot) {
+    return m_elements[slot];
+}
+
+// Counts elements a display had to leave out. A display that stays over the
+// pool drops them on every parse, so the log gets one line per interval.
+void WebDataElementPool::reportDropped(int32_t count) {
+    m_stats.dropped += count;
+    m_unreported += count;
+    if (m_lastReport != 0 && millis() - m_lastReport < WEB_DATA_POOL_REPORT_INTERVAL) {
+        return;
+    }
+    Serial.printf("WebData element pool of %u slots is full, dropped %u elements, raise WEB_DATA_POOL_SLOTS in config.h\n", WEB_DATA_POOL_SLOTS, m_unreported);
+    m_unreported = 0;
+    m_lastReport = millis();
+}
+
+const WebDataPoolStats &WebDataElementPool::getStats() {
+    return m_stats;
+}
+
+void WebDataElementPool::printStats(const char *tag) {
+    Serial.printf("%s elements: %u of %u slots, peak %u, %u acquired, %u released, %u exhausted, %u dropped\n", tag, m_stats.used, WEB_DATA_POOL_SLOTS, m_stats.peak, m_stats.acquired, m_stats.released, m_stats.exhausted, m_stats.dropped);
+}
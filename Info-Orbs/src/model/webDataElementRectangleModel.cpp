@@ -1,115 +1,40 @@
 #include "model/webDataElementRectangleModel.h"
 
-int32_t WebDataElementRectangleModel::getX() {
-    return m_x;
-}
-
-void WebDataElementRectangleModel::setX(int32_t x) {
-    if (m_x != x) {
-        m_x = x;
-        m_changed = true;
-    }
-}
-
-int32_t WebDataElementRectangleModel::getY() {
-    return m_y;
-}
-
-void WebDataElementRectangleModel::setY(int32_t y) {
-    if (m_y != y) {
-        m_y = y;
-        m_changed = true;
-    }
-}
-
-int32_t WebDataElementRectangleModel::getWidth() {
-    return m_width;
-}
-
-void WebDataElementRectangleModel::setWidth(int32_t width) {
-    if (m_width != width) {
-        m_width = width;
-        m_changed = true;
-    }
-}
-
-int32_t WebDataElementRectangleModel::getHeight() {
-    return m_height;
-}
-
-void WebDataElementRectangleModel::setHeight(int32_t height) {
-    if (m_height != height) {
-        m_height = height;
-        m_changed = true;
+// Absent fields keep what the record passed in holds, the size comes from
+// "width"/"height" or from the opposite corner "x2"/"y2"
+const char *WebDataElementRectangleModel::parseData(const JsonObject &doc, WebDataElement &element) {
+    element.x = doc["x1"] | (doc["x"] | element.x);
+    element.y = doc["y1"] | (doc["y"] | element.y);
+    if (doc["width"].is<int32_t>()) {
+        element.v[0] = doc["width"].as<int32_t>();
+    } else if (doc["x2"].is<int32_t>()) {
+        element.v[0] = doc["x2"].as<int32_t>() - element.x;
     }
-}
-
-bool WebDataElementRectangleModel::getFilled() {
-    return m_filled;
-}
-
-void WebDataElementRectangleModel::setFilled(bool filled) {
-    if (m_filled != filled) {
-        m_filled = filled;
-        m_changed = true;
+    if (doc["height"].is<int32_t>()) {
+        element.v[1] = doc["height"].as<int32_t>();
+    } else if (doc["y2"].is<int32_t>()) {
+        element.v[1] = doc["y2"].as<int32_t>() - element.y;
     }
-}
-
-void WebDataElementRectangleModel::setColor(int32_t color) {
-    if (m_color != color) {
-        m_color = color;
-        m_changed = true;
+    if (!doc["filled"].isNull()) {
+        element.flags = doc["filled"].as<bool>() ? element.flags | WEB_DATA_ELEMENT_FILLED : element.flags & ~WEB_DATA_ELEMENT_FILLED;
     }
+    element.color = Utils::colorFromJson(doc["color"], element.color);
+    return nullptr;
 }
 
-void WebDataElementRectangleModel::setColor(String color) {
-    setColor(Utils::stringToColor(color));
-}
-
-int32_t WebDataElementRectangleModel::getColor() {
-    return m_color;
-}
-
-void WebDataElementRectangleModel::parseData(const JsonObject& doc, int32_t defaultColor, int32_t defaultBackground) {
-    if (doc["x1"].is<int32_t>()) {
-        setX(doc["x1"].as<int32_t>());
-    } else if (doc["x"].is<int32_t>()) {
-        setX(doc["x"].as<int32_t>());
-    }
-    if (doc["y1"].is<int32_t>()) {
-        setY(doc["y1"].as<int32_t>());
-    } else if (doc["y"].is<int32_t>()) {
-        setY(doc["y"].as<int32_t>());
-    }
-    if (doc["x2"].is<int32_t>()) {
-        setWidth(doc["x2"].as<int32_t>() - getX());
-    }
-    if (doc["y2"].is<int32_t>()) {
-        setWidth(doc["y2"].as<int32_t>() - getX());
-    }
-    if (int32_t y2 = doc["y2"]) {
-        setHeight(y2 - getY());
-    }
-    if (doc["height"].is<int32_t>()) {
-        setHeight(doc["height"].as<int32_t>());
-    }
-    if (doc["width"].is<int32_t>()) {
-        setWidth(doc["width"].as<int32_t>());
-    }
-    if (doc["filled"].is<bool>()) {
-        setFilled(doc["filled"].as<bool>());
-    }
-    if (const char* color = doc["color"]) {
-        setColor(color);
+void WebDataElementRectangleModel::draw(const WebDataElement &element, const char *text, TFT_eSPI &display) {
+    if (element.flags & WEB_DATA_ELEMENT_FILLED) {
+        display.fillRect(element.x, element.y, element.v[0], element.v[1], element.color);
     } else {
-        setColor(defaultColor);
+        display.drawRect(element.x, element.y, element.v[0], element.v[1], element.color);
     }
 }
 
-void WebDataElementRectangleModel::draw(TFT_eSPI& display) {
-    if (getFilled()) {
-        display.fillRect(getX(), getY(), getWidth(), getHeight(), getColor());
-    } else {
-        display.drawRect(getX(), getY(), getWidth(), getHeight(), getColor());
+WebDataBounds WebDataElementRectangleModel::getBounds(const WebDataElement &element, const char *text, TFT_eSPI &display) {
+    int32_t width = element.v[0];
+    int32_t height = element.v[1];
+    if (width == 0 || height == 0) {
+        return WebDataBounds();
     }
+    return WebDataBounds::fromPoints(element.x, element.y, element.x + width + (width > 0 ? -1 : 1), element.y + height + (height > 0 ? -1 : 1));
 }
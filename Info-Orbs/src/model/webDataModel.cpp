@@ -1,53 +1,226 @@
 #include "model/webDataModel.h"
 
-String WebDataModel::getLabel() {
+#include <textLayout.h>
+
+#include "model/webDataElementImageModel.h"
+
+const FixedString<WEB_DATA_LABEL_LENGTH> &WebDataModel::getLabel() {
     return m_label;
 }
 
-void WebDataModel::setLabel(String label) {
-    if (m_label != label) {
-        m_label = label;
+void WebDataModel::setLabel(StringView label) {
+    if (m_label.set(label, "WebData label")) {
         m_changed = true;
+        m_isInitialized = false;
     }
 }
 
-String WebDataModel::getData() {
+const FixedString<WEB_DATA_DATA_LENGTH> &WebDataModel::getData() {
     return m_data;
 }
 
-void WebDataModel::setData(String data, int32_t defaultColor, int32_t defaultBackground) {
-    if (m_data != data) {
-        m_data = data;
+void WebDataModel::setData(StringView data, int32_t defaultColor, int32_t defaultBackground) {
+    if (m_data.set(data, "WebData data")) {
         setElementsCount(0);
         m_changed = true;
+        m_isInitialized = false;
     }
 }
 void WebDataModel::setData(JsonArray data, int32_t defaultColor, int32_t defaultBackground) {
     setElementsCount(data.size());
-    for (int i = 0; i < data.size(); i++) {
-        m_elements[i].parseData(data[i], defaultColor, defaultBackground);
+    for (int i = 0; i < m_elementsCount; i++) {
+        parseElement(elementAt(i), data[i], defaultColor, defaultBackground, false);
     }
     m_changed = true;
 }
 
-const WebDataElementModel &WebDataModel::getElement(int index) {
-    return m_elements[index];
+// Parses into a fresh record, or with update into a copy of the element so
+// fields doc leaves out keep their values. A delta that changes the type
+// starts fresh, the type specific fields mean something else. Only flags the
+// element when what it draws changed.
+void WebDataModel::parseElement(WebDataElement &element, const JsonObject &doc, int32_t defaultColor, int32_t defaultBackground, bool update) {
+    WebDataElement parsed;
+    if (update && (doc["type"].isNull() || WebDataElementModel::parseType(doc["type"]) == element.type)) {
+        parsed = element;
+    } else {
+        parsed.color = defaultColor;
+        parsed.background = defaultBackground;
+    }
+    const char *text = WebDataElementModel::parseData(doc, parsed);
+    if (text != nullptr) {
+        parsed.text = internText(text);
+    }
+    parsed.drawn = element.drawn;
+    if (!parsed.drawsSameAs(element) || (element.flags & WEB_DATA_ELEMENT_CHANGED)) {
+        parsed.flags |= WEB_DATA_ELEMENT_CHANGED;
+    }
+    element = parsed;
 }
 
-int32_t WebDataModel::getElementsCount() {
-    return m_elementsCount;
+// Called when the image cache changed, image elements are looked up and repainted
+void WebDataModel::refreshImages() {
+    for (int i = 0; i < m_elementsCount; i++) {
+        WebDataElement &element = elementAt(i);
+        if (element.type == IMAGE) {
+            WebDataElementImageModel::refresh(element, getText(element.text));
+            element.flags |= WEB_DATA_ELEMENT_CHANGED;
+            m_changed = true;
+        }
+    }
 }
 
-void WebDataModel::initElements(int32_t count) {
-    if (m_elementsCount > 0) {
-        delete[] m_elements;
+const WebDataElement &WebDataModel::getElement(int index) {
+    return elementAt(index);
+}
+
+WebDataElement &WebDataModel::elementAt(int index) {
+    return m_pool->get(m_slots[index]);
+}
+
+// Must be called before the first parse, the pool outlives the model
+void WebDataModel::setPool(WebDataElementPool *pool) {
+    m_pool = pool;
+}
+
+int32_t WebDataModel::findElement(uint32_t id) {
+    for (int i = 0; i < m_elementsCount; i++) {
+        if (elementAt(i).id == id) {
+            return i;
+        }
     }
-    m_elements = new WebDataElementModel[count];
+    return -1;
 }
+
+const char *WebDataModel::getText(uint16_t offset) {
+    return offset == WEB_DATA_NO_TEXT ? "" : m_text + offset;
+}
+
+// Returns the offset of text in the text table, adding it if it isn't there yet.
+// Identical texts share one entry so unchanged elements keep their offset.
+uint16_t WebDataModel::internText(const char *text) {
+    if (text == nullptr || text[0] == '\0') {
+        return WEB_DATA_NO_TEXT;
+    }
+    for (uint16_t offset = 0; offset < m_textUsed; offset += strlen(m_text + offset) + 1) {
+        if (strcmp(m_text + offset, text) == 0) {
+            return offset;
+        }
+    }
+    size_t length = strlen(text) + 1;
+    if (m_textUsed + length > WEB_DATA_TEXT_SIZE) {
+        compactText();
+    }
+    if (m_textUsed + length > WEB_DATA_TEXT_SIZE) {
+        Serial.printf("WebData text table full, dropping \"%s\"\n", text);
+        return WEB_DATA_NO_TEXT;
+    }
+    uint16_t offset = m_textUsed;
+    memcpy(m_text + offset, text, length);
+    m_textUsed += length;
+    return offset;
+}
+
+// Drops texts no element refers to anymore by sliding the live ones down
+void WebDataModel::compactText() {
+    uint16_t offsets[WEB_DATA_MAX_ELEMENTS];
+    int count = 0;
+    for (int i = 0; i < m_elementsCount; i++) {
+        uint16_t offset = elementAt(i).text;
+        if (offset == WEB_DATA_NO_TEXT) {
+            continue;
+        }
+        int j = count;
+        while (j > 0 && offsets[j - 1] > offset) {
+            j--;
+        }
+        if (j > 0 && offsets[j - 1] == offset) {
+            continue;
+        }
+        memmove(offsets + j + 1, offsets + j, (count - j) * sizeof(uint16_t));
+        offsets[j] = offset;
+        count++;
+    }
+    uint16_t used = 0;
+    for (int i = 0; i < count; i++) {
+        // moved texts only ever go down, below any offset still to be remapped
+        size_t length = strlen(m_text + offsets[i]) + 1;
+        memmove(m_text + used, m_text + offsets[i], length);
+        for (int j = 0; j < m_elementsCount; j++) {
+            if (elementAt(j).text == offsets[i]) {
+                elementAt(j).text = used;
+            }
+        }
+        used += length;
+    }
+    m_textUsed = used;
+}
+
+// Adds, updates or removes the single element named by the delta's "id".
+// "add" carries the full element and goes on top, "update" only the fields
+// that changed.
+void WebDataModel::applyDelta(const JsonObject &delta, int32_t defaultColor, int32_t defaultBackground) {
+    if (delta["id"].isNull()) {
+        Serial.println("WebData delta without element id");
+        return;
+    }
+    const char *op = delta["op"] | "update";
+    int32_t index = findElement(WebDataElementModel::parseId(delta["id"]));
+    if (strcmp(op, "remove") == 0) {
+        if (index == -1) {
+            return;
+        }
+        if (!invalidate(elementAt(index).drawn)) {
+            m_isInitialized = false;
+        }
+        m_pool->release(m_slots[index]);
+        memmove(m_slots + index, m_slots + index + 1, (m_elementsCount - index - 1) * sizeof(m_slots[0]));
+        m_elementsCount--;
+    } else {
+        bool update = index != -1;
+        if (index == -1) {
+            index = m_elementsCount;
+            setElementsCount(m_elementsCount + 1);
+            if (index == m_elementsCount) {
+                return;
+            }
+        }
+        parseElement(elementAt(index), delta, defaultColor, defaultBackground, update);
+    }
+    m_changed = true;
+}
+
+int32_t WebDataModel::getElementsCount() {
+    return m_elementsCount;
+}
+
+// Grows or shrinks the element list, elements that remain are parsed in
+// place. Stops short at WEB_DATA_MAX_ELEMENTS or when the widget's pool runs
+// out of slots.
 void WebDataModel::setElementsCount(int32_t count) {
-    if (m_elementsCount != count) {
-        initElements(count);
-        m_elementsCount = count;
+    if (count > WEB_DATA_MAX_ELEMENTS) {
+        // reported once per change rather than on every refresh
+        if (count != m_truncatedFrom) {
+            Serial.printf("WebData display is limited to %d elements, dropping %d, raise WEB_DATA_MAX_ELEMENTS in config.h\n", WEB_DATA_MAX_ELEMENTS, count - WEB_DATA_MAX_ELEMENTS);
+            m_truncatedFrom = count;
+        }
+        count = WEB_DATA_MAX_ELEMENTS;
+    } else {
+        m_truncatedFrom = 0;
+    }
+    while (m_elementsCount > count) {
+        m_elementsCount--;
+        if (!invalidate(elementAt(m_elementsCount).drawn)) {
+            m_isInitialized = false;
+        }
+        m_pool->release(m_slots[m_elementsCount]);
+    }
+    while (m_elementsCount < count) {
+        int32_t slot = m_pool->acquire();
+        if (slot == -1) {
+            m_pool->reportDropped(count - m_elementsCount);
+            break;
+        }
+        m_slots[m_elementsCount++] = slot;
     }
 }
 
@@ -59,10 +232,11 @@ void WebDataModel::setLabelColor(int32_t color) {
     if (m_labelColor != color) {
         m_labelColor = color;
         m_changed = true;
+        m_isInitialized = false;
     }
 }
 
-void WebDataModel::setLabelColor(String color) {
+void WebDataModel::setLabelColor(const char *color) {
     setLabelColor(Utils::stringToColor(color));
 }
 
@@ -77,7 +251,7 @@ void WebDataModel::setDataColor(int32_t color) {
     }
 }
 
-void WebDataModel::setDataColor(String color) {
+void WebDataModel::setDataColor(const char *color) {
     setDataColor(Utils::stringToColor(color));
 }
 
@@ -89,10 +263,11 @@ void WebDataModel::setBackgroundColor(int32_t background) {
     if (m_background != background) {
         m_background = background;
         m_changed = true;
+        m_isInitialized = false;
     }
 }
 
-void WebDataModel::setBackgroundColor(String background) {
+void WebDataModel::setBackgroundColor(const char *background) {
     setBackgroundColor(Utils::stringToColor(background));
 }
 
@@ -120,24 +295,15 @@ void WebDataModel::parseData(const JsonObject &doc, int32_t defaultColor, int32_
         setData(doc["data"].as<JsonArray>(), defaultColor, defaultBackground);
     } else if (const char *data = doc["data"]) {
         setData(data, defaultColor, defaultBackground);
-    } else if (String data = doc["data"].as<String>()) {
-        setData(data, defaultColor, defaultBackground);
-    }
-    if (const char *color = doc["color"]) {
-        setDataColor(color);
-    } else {
-        setDataColor(defaultColor);
-    }
-    if (const char *labelColor = doc["labelColor"]) {
-        setLabelColor(labelColor);
     } else {
-        setLabelColor(defaultColor);
-    }
-    if (const char *background = doc["background"]) {
-        setBackgroundColor(background);
-    } else {
-        setBackgroundColor(defaultBackground);
+        // numbers and the like are shown the way they appear in the JSON
+        char text[WEB_DATA_DATA_LENGTH + 2];  // a byte more than fits, so set() sees the truncation
+        size_t length = serializeJson(doc["data"], text, sizeof(text));
+        setData(StringView(text, length), defaultColor, defaultBackground);
     }
+    setDataColor(Utils::colorFromJson(doc["color"], defaultColor));
+    setLabelColor(Utils::colorFromJson(doc["labelColor"], defaultColor));
+    setBackgroundColor(Utils::colorFromJson(doc["background"], defaultBackground));
     if (doc["fullDraw"].is<bool>()) {
         setFullDrawStatus(doc["fullDraw"].as<bool>());
     } else {
@@ -153,34 +319,102 @@ void WebDataModel::setInitializedStatus(bool initialized) {
     m_isInitialized = initialized;
 }
 
+// Only repaints what changed: the old and new areas of changed elements are
+// erased with the background, then everything overlapping them is repainted
+// in z-order. A full repaint happens after a reset, on fullDraw or when too
+// many areas are invalid.
 void WebDataModel::draw(TFT_eSPI &display) {
+    unsigned long start = micros();
+    if (m_isInitialized && !isFullDraw() && !m_redrawAll) {
+        for (int i = 0; i < m_elementsCount && m_isInitialized; i++) {
+            WebDataElement &element = elementAt(i);
+            if ((element.flags & WEB_DATA_ELEMENT_CHANGED) &&
+                (!invalidate(element.drawn) || !invalidate(WebDataElementModel::getBounds(element, getText(element.text), display)))) {
+                m_isInitialized = false;
+            }
+        }
+    }
     if (!m_isInitialized || isFullDraw()) {
         display.fillScreen(getBackgroundColor());
         m_isInitialized = true;
+        m_redrawAll = true;
+        m_invalidCount = 0;
+    }
+    for (int i = 0; i < m_invalidCount; i++) {
+        display.fillRect(m_invalid[i].x, m_invalid[i].y, m_invalid[i].w, m_invalid[i].h, getBackgroundColor());
     }
-    if (getLabel()) {
-        display.setTextColor(getLabelColor());
+    if (!m_label.isEmpty()) {
         display.setTextSize(2);
-        display.setTextDatum(MC_DATUM);
-        display.drawString(getLabel(), 120, 70, 2);
+        WebDataBounds labelBounds = WebDataBounds::fromText(120, 70, display.textWidth(m_label.c_str(), 2), display.fontHeight(2), MC_DATUM);
+        if (m_redrawAll || isInvalidated(labelBounds)) {
+            display.setTextColor(getLabelColor());
+            display.setTextDatum(MC_DATUM);
+            display.drawString(m_label.c_str(), 120, 70, 2);
+        }
     }
     display.setTextDatum(MC_DATUM);
 
+    int drawn = 0;
     if (getElementsCount() > 0) {
+        bool repaintRest = m_redrawAll;
         for (int i = 0; i < getElementsCount(); i++) {
-            WebDataElementModel element = getElement(i);
-            element.draw(display);
+            WebDataElement &element = elementAt(i);
+            if (repaintRest || (element.flags & WEB_DATA_ELEMENT_CHANGED) || isInvalidated(element.drawn)) {
+                const char *text = getText(element.text);
+                element.drawn = WebDataElementModel::getBounds(element, text, display);
+                WebDataElementModel::draw(element, text, display);
+                element.flags &= ~WEB_DATA_ELEMENT_CHANGED;
+                drawn++;
+                // whatever is above this element has to be repainted too
+                if (!repaintRest && !invalidate(element.drawn)) {
+                    repaintRest = true;
+                }
+            }
         }
-    } else {
+    } else if (m_redrawAll) {
         display.setTextColor(getDataColor(), getBackgroundColor());
 
-        String wrappedLines[MAX_WRAPPED_LINES];
-        String dataValues = getData();
+        TextLayout layout(display, 2, 2);
+        char buffer[WEB_DATA_WRAP_BUFFER];
+        const char *lines[MAX_WRAPPED_LINES];
         int yOffset = 110;
-        int lineCount = Utils::getWrappedLines(wrappedLines, dataValues, 10);
-        int height = display.fontHeight() + 10;
+        int height = layout.getFontHeight() + 10;
+        int lineCount = layout.wrap(getData().c_str(), yOffset, height, buffer, sizeof(buffer), lines, MAX_WRAPPED_LINES);
+        display.setTextSize(2);
         for (int i = 0; i < lineCount; i++) {
-            display.drawString(wrappedLines[i], 120, yOffset + (height * i), 2);
+            display.drawString(lines[i], 120, yOffset + (height * i), 2);
+        }
+    }
+    if (m_redrawAll && getElementsCount() > 0) {
+        Serial.printf("WebData drew %d elements in %lu us, %d bytes each plus %u bytes of text\n", drawn, micros() - start, (int)sizeof(WebDataElement), m_textUsed);
+    }
+    m_redrawAll = false;
+    m_invalidCount = 0;
+}
+
+// Queues an area to be erased and repainted, false when there is no room left
+bool WebDataModel::invalidate(const WebDataBounds &bounds) {
+    if (bounds.isEmpty()) {
+        return true;
+    }
+    for (int i = 0; i < m_invalidCount; i++) {
+        const WebDataBounds &area = m_invalid[i];
+        if (bounds.x >= area.x && bounds.y >= area.y && bounds.x + bounds.w <= area.x + area.w && bounds.y + bounds.h <= area.y + area.h) {
+            return true;
+        }
+    }
+    if (m_invalidCount == WEB_DATA_MAX_DIRTY_REGIONS) {
+        return false;
+    }
+    m_invalid[m_invalidCount++] = bounds;
+    return true;
+}
+
+bool WebDataModel::isInvalidated(const WebDataBounds &bounds) {
+    for (int i = 0; i < m_invalidCount; i++) {
+        if (m_invalid[i].intersects(bounds)) {
+            return true;
         }
     }
+    return false;
 }
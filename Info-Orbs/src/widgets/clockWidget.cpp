@@ -3,17 +3,19 @@
 #include <config.h>
 #include <globalTime.h>
 
-ClockWidget::ClockWidget(ScreenManager& manager) : Widget(manager) {
+static const uint32_t REDRAW_LATENCY_BOUNDS[] = {1, 2, 5, 10, 20, 50, 100, 200, 500};
+
+ClockWidget::ClockWidget(ScreenManager& manager) : Widget(manager), m_redrawLatency("Clock redraw latency", "ms", REDRAW_LATENCY_BOUNDS, sizeof(REDRAW_LATENCY_BOUNDS) / sizeof(REDRAW_LATENCY_BOUNDS[0])) {
 }
 
 ClockWidget::~ClockWidget() {
 }
 
 void ClockWidget::setup() {
-    m_lastDisplay1Didget = "-1";
-    m_lastDisplay2Didget = "-1";
-    m_lastDisplay4Didget = "-1";
-    m_lastDisplay5Didget = "-1";
+    m_lastDisplay1Didget = '-';
+    m_lastDisplay2Didget = '-';
+    m_lastDisplay4Didget = '-';
+    m_lastDisplay5Didget = '-';
 }
 
 void ClockWidget::draw(bool force) {
@@ -22,7 +24,7 @@ void ClockWidget::draw(bool force) {
     if (m_lastDisplay1Didget != m_display1Didget || force) {
         displayDidget(0, m_display1Didget, 7, 5, FOREGROUND_COLOR);
         m_lastDisplay1Didget = m_display1Didget;
-        if (SHADOWING != 1 &&m_display1Didget == " ") {
+        if (SHADOWING != 1 &&m_display1Didget == ' ') {
             m_manager.clearScreen(0);
         }
     }
@@ -45,7 +47,7 @@ void ClockWidget::draw(bool force) {
         } else {
             displayDidget(2, ":", 7, 5, BG_COLOR, false);
         }
-#if SHOW_SECOND_TICKS == true        
+#if SHOW_SECOND_TICKS == true && SHOW_SECOND_SWEEP != true
         displaySeconds(2, m_lastSecondSingle, TFT_BLACK);
         displaySeconds(2, m_secondSingle, FOREGROUND_COLOR);
 #endif
@@ -53,7 +55,37 @@ void ClockWidget::draw(bool force) {
         if (!FORMAT_24_HOUR && SHOW_AM_PM_INDICATOR) {
             displayAmPm(FOREGROUND_COLOR);
         }
+        if (!force) {
+            m_redrawLatency.add(time->getEpochMillis() % 1000);
+        }
+    }
+#if SHOW_SECOND_SWEEP == true
+    if (force) {
+        m_sweep.reset();
     }
+    int64_t epochMillis = time->getEpochMillis();
+    if (m_sweep.isFrameDue(epochMillis)) {
+        m_manager.selectScreen(2);
+        m_sweep.drawFrame(m_manager.getDisplay(), epochMillis, FOREGROUND_COLOR, TFT_BLACK);
+    }
+#endif
+    if (millis() - m_lastReport >= CLOCK_REPORT_INTERVAL) {
+        m_lastReport = millis();
+        m_redrawLatency.print();
+        m_redrawLatency.reset();
+#if SHOW_SECOND_SWEEP == true
+        m_sweep.printStats();
+        m_sweep.resetStats();
+#endif
+    }
+}
+
+float ClockWidget::getSweepFps() {
+    return m_sweep.getFps();
+}
+
+uint32_t ClockWidget::getSweepDroppedFrames() {
+    return m_sweep.getDroppedFrames();
 }
 
 void ClockWidget::displayAmPm(uint32_t color) {
@@ -62,16 +94,20 @@ void ClockWidget::displayAmPm(uint32_t color) {
     TFT_eSPI& display = m_manager.getDisplay();
     display.setTextSize(4);
     display.setTextColor(color, TFT_BLACK, true);
-    String am_pm = time->isPM() ? "PM" : "AM";
+    const char *am_pm = time->isPM() ? "PM" : "AM";
     display.drawString(am_pm, SCREEN_SIZE - 50, SCREEN_SIZE / 2, 1);
 }
 
 void ClockWidget::update(bool force) {
-    if (millis() - m_secondTimerPrev < m_secondTimer && !force) {
+    GlobalTime* time = GlobalTime::getInstance();
+    // the loop updates GlobalTime first, so this is the moment the second starts
+    if (time->getUtcEpoch() == m_lastEpoch && !force) {
         return;
     }
-
-    GlobalTime* time = GlobalTime::getInstance();
+    m_lastEpoch = time->getUtcEpoch();
+    if (time->isSynced()) {
+        markDataReceived();
+    }
     m_hourSingle = time->getHour();
 
     m_minuteSingle = time->getMinute();
@@ -80,23 +116,21 @@ void ClockWidget::update(bool force) {
     if (m_lastHourSingle != m_hourSingle || force) {
         if (m_hourSingle < 10) {
             if (FORMAT_24_HOUR) {
-                m_display1Didget = "0";
+                m_display1Didget = '0';
             } else {
-                m_display1Didget = " ";
+                m_display1Didget = ' ';
             }
         } else {
-            m_display1Didget = int(m_hourSingle/10);
+            m_display1Didget = '0' + m_hourSingle / 10;
         }
-        m_display2Didget = m_hourSingle % 10;
+        m_display2Didget = '0' + m_hourSingle % 10;
 
         m_lastHourSingle = m_hourSingle;
     }
 
     if (m_lastMinuteSingle != m_minuteSingle || force) {
-        String currentMinutePadded = String(m_minuteSingle).length() == 1 ? "0" + String(m_minuteSingle) : String(m_minuteSingle);
-
-        m_display4Didget = currentMinutePadded.substring(0, 1);
-        m_display5Didget = currentMinutePadded.substring(1, 2);
+        m_display4Didget = '0' + m_minuteSingle / 10;
+        m_display5Didget = '0' + m_minuteSingle % 10;
 
         m_lastMinuteSingle = m_minuteSingle;
     }
@@ -108,7 +142,7 @@ void ClockWidget::changeMode() {
     draw(true);
 }
 
-void ClockWidget::displayDidget(int displayIndex, const String& didget, int font, int fontSize, uint32_t color, bool shadowing) {
+void ClockWidget::displayDidget(int displayIndex, const char* didget, int font, int fontSize, uint32_t color, bool shadowing) {
     m_manager.selectScreen(displayIndex);
     TFT_eSPI& display = m_manager.getDisplay();
     display.setTextSize(fontSize);
@@ -122,10 +156,15 @@ void ClockWidget::displayDidget(int displayIndex, const String& didget, int font
     display.drawString(didget, SCREEN_SIZE / 2, SCREEN_SIZE / 2, font);
 }
 
-void ClockWidget::displayDidget(int displayIndex, const String& didget, int font, int fontSize, uint32_t color) {
+void ClockWidget::displayDidget(int displayIndex, const char* didget, int font, int fontSize, uint32_t color) {
     this->displayDidget(displayIndex, didget, font, fontSize, color, SHADOWING);
 }
 
+void ClockWidget::displayDidget(int displayIndex, char didget, int font, int fontSize, uint32_t color) {
+    char text[2] = {didget, '\0'};
+    this->displayDidget(displayIndex, text, font, fontSize, color, SHADOWING);
+}
+
 void ClockWidget::displaySeconds(int displayIndex, int seconds, int color) {
     m_manager.reset();
     m_manager.selectScreen(displayIndex);
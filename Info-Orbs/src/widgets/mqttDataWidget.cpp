@@ -0,0 +1,186 @@
+#include "widgets/mqttDataWidget.h"
+
+#include <config.h>
+#include <heapAccounting.h>
+#include <imageCache.h>
+
+MqttDataWidget::MqttDataWidget(ScreenManager &manager, String host, String topics) : Widget(manager), m_host(host), m_client(m_wifiClient) {
+    char topicList[topics.length() + 1];
+    topics.toCharArray(topicList, topics.length() + 1);
+
+    char *topic = strtok(topicList, ",");
+    while (topic != nullptr) {
+        if (m_topicCount >= MQTT_MAX_TOPICS) {
+            Serial.println("MAX MQTT TOPICS UNABLE TO ADD MORE");
+            break;
+        }
+        m_topics[m_topicCount] = String(topic);
+        m_topics[m_topicCount].trim();
+        m_topicCount++;
+        topic = strtok(nullptr, ",");
+    }
+    for (WebDataModel &model : m_obj) {
+        model.setPool(&m_pool);
+    }
+    m_lock = xSemaphoreCreateMutex();
+}
+
+// The client task may be inside m_client or hold m_lock, so it is asked to
+// stop and only deleted once it has left its loop
+MqttDataWidget::~MqttDataWidget() {
+    if (m_task != nullptr) {
+        m_stopper = xTaskGetCurrentTaskHandle();
+        m_stopRequested = true;
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        vTaskDelete(m_task);
+    } else {
+        m_client.disconnect();
+    }
+    vSemaphoreDelete(m_lock);
+}
+
+void MqttDataWidget::setup() {
+    if (m_task != nullptr) {
+        return;
+    }
+    m_client.setServer(m_host.c_str(), MQTT_BROKER_PORT);
+    m_client.setBufferSize(MQTT_BUFFER_SIZE);
+    m_client.setKeepAlive(MQTT_KEEP_ALIVE);
+    m_client.setCallback([this](char *topic, byte *payload, unsigned int length) {
+        onMessage(topic, payload, length);
+    });
+    // The client lives on the other core so the connection and keep-alive are
+    // serviced even while another widget is shown
+    xTaskCreatePinnedToCore(clientTask, "mqtt", 6144, this, 1, &m_task, 0);
+}
+
+void MqttDataWidget::clientTask(void *param) {
+    MqttDataWidget *widget = static_cast<MqttDataWidget *>(param);
+    while (!widget->m_stopRequested) {
+        if (WiFi.status() == WL_CONNECTED) {
+            if (widget->m_client.connected() || widget->reconnect()) {
+                widget->m_client.loop();
+            }
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    widget->m_client.disconnect();
+    // the destructor deletes this task once it is parked here
+    xTaskNotifyGive(widget->m_stopper);
+    vTaskSuspend(nullptr);
+}
+
+bool MqttDataWidget::reconnect() {
+    if (m_lastConnectAttempt != 0 && millis() - m_lastConnectAttempt < MQTT_RECONNECT_DELAY) {
+        return false;
+    }
+    m_lastConnectAttempt = millis();
+
+    String clientId = "info-orbs-" + String((uint32_t)ESP.getEfuseMac(), HEX);
+#ifdef MQTT_USER
+    bool connected = m_client.connect(clientId.c_str(), MQTT_USER, MQTT_PASS);
+#else
+    bool connected = m_client.connect(clientId.c_str());
+#endif
+    if (!connected) {
+        Serial.printf("MQTT connection to %s failed, state: %d\n", m_host.c_str(), m_client.state());
+        return false;
+    }
+    Serial.println("MQTT connected to " + m_host);
+    for (int8_t i = 0; i < m_topicCount; i++) {
+        m_client.subscribe(m_topics[i].c_str());
+    }
+    return true;
+}
+
+// Runs on the client task. Only stores the payload, parsing happens in update()
+void MqttDataWidget::onMessage(char *topic, byte *payload, unsigned int length) {
+    unsigned long now = millis();
+    for (int8_t i = 0; i < m_topicCount; i++) {
+        if (m_topics[i] != topic) {
+            continue;
+        }
+        xSemaphoreTake(m_lock, portMAX_DELAY);
+        m_pending[i] = "";
+        m_pending[i].concat((const char *)payload, length);
+        m_hasPending[i] = true;
+        m_receivedAt[i] = now;
+        xSemaphoreGive(m_lock);
+    }
+}
+
+void MqttDataWidget::update(bool force) {
+    uint32_t imageGeneration = ImageCache::getInstance()->getGeneration();
+    if (imageGeneration != m_imageGeneration) {
+        // images arrive in the background after the element was parsed
+        m_imageGeneration = imageGeneration;
+        for (WebDataModel &model : m_obj) {
+            model.refreshImages();
+        }
+    }
+    for (int8_t i = 0; i < m_topicCount; i++) {
+        String payload;
+        xSemaphoreTake(m_lock, portMAX_DELAY);
+        bool pending = m_hasPending[i];
+        if (pending) {
+            payload = m_pending[i];
+            m_hasPending[i] = false;
+            m_parsedReceivedAt[i] = m_receivedAt[i];
+        }
+        xSemaphoreGive(m_lock);
+        if (!pending) {
+            continue;
+        }
+
+        JsonDocument doc(&m_jsonArena);
+        DeserializationError error;
+        {
+            HeapTagGuard jsonTag("json");
+            error = deserializeJson(doc, payload);
+        }
+        if (!error) {
+            m_obj[i].parseData(doc.as<JsonObject>(), m_defaultColor, m_defaultBackground);
+            markDataReceived();
+        } else {
+            Serial.printf("deserializeJson() failed for MQTT topic %s: %s\n", m_topics[i].c_str(), error.c_str());
+            m_jsonArena.printStats();
+        }
+    }
+}
+
+void MqttDataWidget::draw(bool force) {
+    for (int8_t i = 0; i < m_topicCount; i++) {
+        WebDataModel *data = &m_obj[i];
+        if (force) {
+            data->setInitializedStatus(false);
+        }
+        if (data->isChanged() || force) {
+            m_manager.selectScreen(i);
+            data->draw(m_manager.getDisplay());
+            data->setChangedStatus(false);
+            if (m_parsedReceivedAt[i] != 0) {
+                unsigned long latency = millis() - m_parsedReceivedAt[i];
+                Serial.printf("MQTT %s: %lu ms message-to-pixel\n", m_topics[i].c_str(), latency);
+#ifdef MQTT_SHOW_LATENCY
+                drawLatency(m_manager.getDisplay(), latency);
+#endif
+                m_parsedReceivedAt[i] = 0;
+            }
+        }
+    }
+}
+
+// Small label at the bottom of the orb, replaced with every message
+void MqttDataWidget::drawLatency(TFT_eSPI &display, unsigned long latency) {
+    char text[16];
+    snprintf(text, sizeof(text), "%lu ms", latency);
+    display.setTextSize(1);
+    display.setTextDatum(BC_DATUM);
+    display.setTextColor(TFT_DARKGREY, TFT_BLACK);
+    display.setTextPadding(display.textWidth("99999 ms", 2));
+    display.drawString(text, 120, MQTT_LATENCY_Y, 2);
+    display.setTextPadding(0);
+}
+
+void MqttDataWidget::changeMode() {
+}
@@ -3,6 +3,9 @@
 #include <ArduinoJson.h>
 #include <HTTPClient.h>
 #include <config.h>
+#include <fetchPolicy.h>
+#include <heapAccounting.h>
+#include <inflateStream.h>
 
 #include <iomanip>
 
@@ -14,7 +17,7 @@ StockWidget::StockWidget(ScreenManager &manager) : Widget(manager) {
     m_stockCount = 0;
     do {
         StockDataModel stockModel = StockDataModel();
-        stockModel.setSymbol(String(symbol));
+        stockModel.setSymbol(symbol);
         m_stocks[m_stockCount] = stockModel;
         m_stockCount++;
         if (m_stockCount > MAX_STOCKS) {
@@ -25,6 +28,7 @@ StockWidget::StockWidget(ScreenManager &manager) : Widget(manager) {
 }
 
 void StockWidget::setup() {
+    m_poll.setMarketHours(true);
     if (m_stockCount == 0) {
         Serial.println("No stock tickers available");
         return;
@@ -41,13 +45,25 @@ void StockWidget::draw(bool force) {
 }
 
 void StockWidget::update(bool force) {
-    if (force || m_stockDelayPrev == 0 || (millis() - m_stockDelayPrev) >= m_stockDelay) {
+    if (force || m_poll.isDue()) {
         setBusy(true);
+        bool changed = false;
+        bool success = true;
+        uint32_t allocations = HeapAccounting::getAllocationCount();
         for (int8_t i = 0; i < m_stockCount; i++) {
-            getStockData(m_stocks[i]);
+            if (!getStockData(m_stocks[i])) {
+                success = false;
+            }
+            changed = changed || m_stocks[i].isChanged();
         }
+        HeapAccounting::printAllocations("Stock refresh", allocations);
+        m_jsonArena.printStats();
         setBusy(false);
-        m_stockDelayPrev = millis();
+        if (success) {
+            m_poll.onResult(changed);
+        } else {
+            m_poll.onFailure();
+        }
     }
 }
 
@@ -55,17 +71,32 @@ void StockWidget::changeMode() {
     update(true);
 }
 
-void StockWidget::getStockData(StockDataModel &stock) {
-    String httpRequestAddress = "https://api.marketdata.app/v1/stocks/quotes/" + stock.getSymbol() + "/?token=aVhwT1NWWkhIZVBRZlIwOUlHb01keWFrMEI5Ql9QM1ZIZndtay1ub0V3OD0";
+bool StockWidget::getStockData(StockDataModel &stock) {
+    String httpRequestAddress = String("https://api.marketdata.app/v1/stocks/quotes/") + stock.getSymbol().c_str() + "/?token=aVhwT1NWWkhIZVBRZlIwOUlHb01keWFrMEI5Ql9QM1ZIZndtay1ub0V3OD0";
+    if (!FetchPolicy::getInstance()->allowRequest(httpRequestAddress)) {
+        return false;
+    }
 
+    bool success = false;
+    HeapTagGuard httpTag("http");
     HTTPClient http;
     http.begin(httpRequestAddress);
+    InflateStream::prepare(http);
     int httpCode = http.GET();
+    FetchPolicy::getInstance()->reportResult(httpRequestAddress, httpCode);
 
     if (httpCode > 0) {  // Check for the returning code
-        String payload = http.getString();
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, payload);
+        m_poll.setMaxAge(http.header("Cache-Control"));
+        JsonDocument doc(&m_jsonArena);
+        InflateStream body(http.getStream(), http.header("Content-Encoding"));
+        DeserializationError error;
+        {
+            HeapTagGuard jsonTag("json");
+            error = deserializeJson(doc, body);
+        }
+        FixedString<STOCK_SYMBOL_LENGTH + 6> endpoint;
+        endpoint.format("stock %s", stock.getSymbol().c_str());
+        body.printStats(endpoint.c_str());
 
         if (!error) {
             float currentPrice = doc["last"][0].as<float>();
@@ -74,12 +105,14 @@ void StockWidget::getStockData(StockDataModel &stock) {
                 stock.setPercentChange(doc["changepct"][0].as<float>());
                 stock.setPriceChange(doc["change"][0].as<float>());
                 stock.setVolume(doc["volume"][0].as<float>());
+                success = true;
+                markDataReceived();
             } else {
-                Serial.println("skipping invalid data for: " + stock.getSymbol());
+                Serial.printf("skipping invalid data for: %s\n", stock.getSymbol().c_str());
             }
         } else {
             // Handle JSON deserialization error
-            Serial.println("deserializeJson() failed");
+            Serial.printf("deserializeJson() failed: %s\n", error.c_str());
         }
     } else {
         // Handle HTTP request error
@@ -87,10 +120,11 @@ void StockWidget::getStockData(StockDataModel &stock) {
     }
 
     http.end();
+    return success;
 }
 
 void StockWidget::displayStock(int8_t displayIndex, StockDataModel &stock, uint32_t backgroundColor, uint32_t textColor) {
-    Serial.println("displayStock - " + stock.getSymbol() + " ~ " + stock.getCurrentPrice());
+    Serial.printf("displayStock - %s ~ %s\n", stock.getSymbol().c_str(), stock.getCurrentPrice(2).c_str());
     if (stock.getCurrentPrice() == 0.0) {
         // there isn't any data to display yet
         return;
@@ -109,8 +143,10 @@ void StockWidget::displayStock(int8_t displayIndex, StockDataModel &stock, uint3
 
     // Draw stock data
     display.fillRect(0, 0, screenWidth, 50, 0x0256);  // rgb565 colors
-    display.drawString(stock.getSymbol(), centre, 27, 1);
-    display.drawString("$" + stock.getCurrentPrice(2), centre, 51 + display.fontHeight(1), 1);
+    FixedString<FormattedFloat::capacity() + 1> text;
+    display.drawString(stock.getSymbol().c_str(), centre, 27, 1);
+    text.format("$%s", stock.getCurrentPrice(2).c_str());
+    display.drawString(text.c_str(), centre, 51 + display.fontHeight(1), 1);
 
     if (stock.getPercentChange() < 0.0) {
         display.setTextColor(TFT_RED, TFT_BLACK);
@@ -120,5 +156,6 @@ void StockWidget::displayStock(int8_t displayIndex, StockDataModel &stock, uint3
         display.fillTriangle(120, 185, 140, 220, 100, 220, TFT_GREEN);
     }
 
-    display.drawString(stock.getPercentChange(2) + "%", centre, 147, 1);
+    text.format("%s%%", stock.getPercentChange(2).c_str());
+    display.drawString(text.c_str(), centre, 147, 1);
 }
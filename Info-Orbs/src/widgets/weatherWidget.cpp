@@ -3,6 +3,11 @@
 #include "icons.h"
 
 #include <config.h>
+#include <fetchPolicy.h>
+#include <heapAccounting.h>
+#include <inflateStream.h>
+#include <lookupTable.h>
+#include <textLayout.h>
 
 WeatherWidget::WeatherWidget(ScreenManager &manager) : Widget(manager) {
     m_mode = MODE_HIGHS;
@@ -20,7 +25,6 @@ void WeatherWidget::changeMode() {
 }
 
 void WeatherWidget::setup() {
-    m_lastUpdate = millis() - m_updateDelay + 1000;
     m_time = GlobalTime::getInstance();
 }
 
@@ -35,7 +39,7 @@ void WeatherWidget::draw(bool force) {
     // Weather, displays a clock, city & text weather discription, weather icon, temp, 3 day forecast
     if (force || model.isChanged()) {
         weatherText(1, TFT_WHITE, TFT_BLACK);
-        drawWeatherIcon(model.getCurrentIcon(), 2, 0, 0, 1);
+        drawWeatherIcon(model.getCurrentIcon().c_str(), 2, 0, 0, 1);
         singleWeatherDeg(3, TFT_WHITE, TFT_BLACK);
         threeDayWeather(4);
         model.setChangedStatus(false);
@@ -43,41 +47,55 @@ void WeatherWidget::draw(bool force) {
 }
 
 void WeatherWidget::update(bool force) {
-    if (force || m_lastUpdate == 0 || (millis() - m_lastUpdate) >= m_updateDelay) {
+    // retries after a failure are paced by FetchPolicy instead of being sent back to back
+    if ((force || m_poll.isDue()) && FetchPolicy::getInstance()->allowRequest(httpRequestAddress)) {
         setBusy(true);
-        if (force) {
-            int retry = 0;
-            while (!getWeatherData() && retry++ < MAX_RETRIES);
+        uint32_t allocations = HeapAccounting::getAllocationCount();
+        bool success = getWeatherData();
+        HeapAccounting::printAllocations("Weather refresh", allocations);
+        setBusy(false);
+        if (success) {
+            m_poll.onResult(model.isChanged());
         } else {
-            getWeatherData();
+            m_poll.onFailure();
         }
-        setBusy(false);
-        m_lastUpdate = millis();
     }
 }
 
 bool WeatherWidget::getWeatherData() {
+    HeapTagGuard httpTag("http");
     HTTPClient http;
     http.begin(httpRequestAddress);
+    InflateStream::prepare(http);
     int httpCode = http.GET();
+    FetchPolicy::getInstance()->reportResult(httpRequestAddress, httpCode);
     if (httpCode > 0) {  // Check for the returning code
-        JsonDocument doc;
-        DeserializationError error = deserializeJson(doc, http.getString());
+        m_poll.setMaxAge(http.header("Cache-Control"));
+        JsonDocument doc(&m_jsonArena);
+        InflateStream body(http.getStream(), http.header("Content-Encoding"));
+        DeserializationError error;
+        {
+            HeapTagGuard jsonTag("json");
+            error = deserializeJson(doc, body);
+        }
+        body.printStats("weather");
+        m_jsonArena.printStats();
         http.end();
 
         if (!error) {
-            model.setCityName(doc["resolvedAddress"].as<String>());
+            model.setCityName(doc["resolvedAddress"].as<const char *>());
             model.setCurrentTemperature(doc["currentConditions"]["temp"].as<float>());
-            model.setCurrentText(doc["days"][0]["description"].as<String>());
+            model.setCurrentText(doc["days"][0]["description"].as<const char *>());
 
-            model.setCurrentIcon(doc["currentConditions"]["icon"].as<String>());
+            model.setCurrentIcon(doc["currentConditions"]["icon"].as<const char *>());
             model.setTodayHigh(doc["days"][0]["tempmax"].as<float>());
             model.setTodayLow(doc["days"][0]["tempmin"].as<float>());
             for (int i = 0; i < 3; i++) {
-                model.setDayIcon(i, doc["days"][i + 1]["icon"].as<String>());
+                model.setDayIcon(i, doc["days"][i + 1]["icon"].as<const char *>());
                 model.setDayHigh(i, doc["days"][i + 1]["tempmax"].as<float>());
                 model.setDayLow(i, doc["days"][i + 1]["tempmin"].as<float>());
             }
+            markDataReceived();
         } else {
             // Handle JSON deserialization error
             switch (error.code()) {
@@ -120,11 +138,13 @@ void WeatherWidget::displayClock(int displayIndex, uint32_t background, uint32_t
     display.setTextColor(color);
     display.setTextSize(2);
     display.setTextDatum(MC_DATUM);
+    char date[GLOBAL_TIME_NAME_LENGTH + 4];
 #ifdef WEATHER_UNITS_METRIC
-    display.drawString(String(m_time->getDay()) + " " + m_time->getMonthName(), centre, 151, 2);
+    snprintf(date, sizeof(date), "%d %s", m_time->getDay(), m_time->getMonthName());
 #else
-    display.drawString(m_time->getMonthName() + " " + String(m_time->getDay()), centre, 151, 2);
+    snprintf(date, sizeof(date), "%s %d", m_time->getMonthName(), m_time->getDay());
 #endif
+    display.drawString(date, centre, 151, 2);
     display.setTextSize(3);
     display.drawString(m_time->getWeekday(), centre, 178, 2);
     display.setTextColor(color);
@@ -155,32 +175,53 @@ void WeatherWidget::showJPG(int displayIndex, int x, int y, const byte jpgData[]
 }
 
 // This takes the text output form the weatehr API and maps it to arespective icon/byte aarray, then displays it,
-void WeatherWidget::drawWeatherIcon(String condition, int displayIndex, int x, int y, int scale) {
+void WeatherWidget::drawWeatherIcon(const char *condition, int displayIndex, int x, int y, int scale) {
+    enum WeatherIcon { MOON_CLOUD, SUN_CLOUDS, SUN, MOON, SNOW, RAIN, CLOUDS, UNKNOWN };
+    static constexpr auto icons = makeLookupTable<WeatherIcon>({
+        {"partly-cloudy-night", MOON_CLOUD},
+        {"partly-cloudy-day", SUN_CLOUDS},
+        {"clear-day", SUN},
+        {"clear-night", MOON},
+        {"snow", SNOW},
+        {"rain", RAIN},
+        {"fog", CLOUDS},
+        {"wind", CLOUDS},
+        {"cloudy", CLOUDS},
+    });
     const byte *icon = NULL;
     int size = 0;
-    if (condition == "partly-cloudy-night") {
-        icon = moonCloud_start;
-        size = moonCloud_end - moonCloud_start;
-    } else if (condition == "partly-cloudy-day") {
-        icon = sunClouds_start;
-        size = sunClouds_end - sunClouds_start;
-    } else if (condition == "clear-day") {
-        icon = sun_start;
-        size = sun_end - sun_start;
-    } else if (condition == "clear-night") {
-        icon = moon_start;
-        size = moon_end - moon_start;
-    } else if (condition == "snow") {
-        icon = snow_start;
-        size = snow_end - snow_start;
-    } else if (condition == "rain") {
-        icon = rain_start;
-        size = rain_end - rain_start;
-    } else if (condition == "fog" || condition == "wind" || condition == "cloudy") {
-        icon = clouds_start;
-        size = clouds_end - clouds_start;
-    } else {
-        Serial.println("unknown weather icon:" + condition);
+    switch (icons.get(condition, UNKNOWN)) {
+        case MOON_CLOUD:
+            icon = moonCloud_start;
+            size = moonCloud_end - moonCloud_start;
+            break;
+        case SUN_CLOUDS:
+            icon = sunClouds_start;
+            size = sunClouds_end - sunClouds_start;
+            break;
+        case SUN:
+            icon = sun_start;
+            size = sun_end - sun_start;
+            break;
+        case MOON:
+            icon = moon_start;
+            size = moon_end - moon_start;
+            break;
+        case SNOW:
+            icon = snow_start;
+            size = snow_end - snow_start;
+            break;
+        case RAIN:
+            icon = rain_start;
+            size = rain_end - rain_start;
+            break;
+        case CLOUDS:
+            icon = clouds_start;
+            size = clouds_end - clouds_start;
+            break;
+        default:
+            Serial.printf("unknown weather icon:%s\n", condition);
+            break;
     }
     if (icon != NULL && size > 0) {
         showJPG(displayIndex, x, y, icon, size, scale);
@@ -195,7 +236,7 @@ void WeatherWidget::singleWeatherDeg(int displayIndex, uint32_t backgroundColor,
     TFT_eSPI &display = m_manager.getDisplay();
     display.fillScreen(backgroundColor);
 
-    drawDegrees(model.getCurrentTemperature(0), centre, 100, 8, 1, 15, 8, textColor, backgroundColor);
+    drawDegrees(model.getCurrentTemperature(0).c_str(), centre, 100, 8, 1, 15, 8, textColor, backgroundColor);
 
     display.fillRect(0, 170, 240, 70, TFT_BLACK);
 
@@ -204,48 +245,32 @@ void WeatherWidget::singleWeatherDeg(int displayIndex, uint32_t backgroundColor,
     display.setTextColor(TFT_WHITE);
     display.setTextSize(2);
     display.drawString("High", 80, 190, 1);
-    drawDegrees(model.getTodayHigh(0), 80, 210, 1, 2, 4, 2, TFT_WHITE, TFT_BLACK);
+    drawDegrees(model.getTodayHigh(0).c_str(), 80, 210, 1, 2, 4, 2, TFT_WHITE, TFT_BLACK);
     display.drawString("Low", 160, 190, 1);
-    drawDegrees(model.getTodayLow(0), 160, 210, 1, 2, 4, 2, TFT_WHITE, TFT_BLACK);
+    drawDegrees(model.getTodayLow(0).c_str(), 160, 210, 1, 2, 4, 2, TFT_WHITE, TFT_BLACK);
 }
 
 // This displays the users current city and the text desctiption of the weather. Pass in display number, background color, text color
 void WeatherWidget::weatherText(int displayIndex, int16_t b, int16_t t) {
     m_manager.selectScreen(displayIndex);
     TFT_eSPI &display = m_manager.getDisplay();
-    //=== TEXT OVERFLOW ============================
-    // this takes a given string a and breaks it down in max x character long strings ensuring not to break it only at a space.
-    // given the small width of the screens this will porbablly be needed to this project again so making sure to outline it
-    // clearly as this should liekly eventually be turned into a fucntion. Before use the array size should be made to be dynamic.
-    // In this case its used for the weather text description
-
-    String message = model.getCurrentText() + " ";
-    String messageArr[4];
-    int variableRangeS = 0;
-    int variableRangeE = 18;
-    for (int i = 0; i < 4; i++) {
-        while (message.substring(variableRangeE - 1, variableRangeE) != " ") {
-            variableRangeE--;
-        }
-        messageArr[i] = message.substring(variableRangeS, variableRangeE);
-        variableRangeS = variableRangeE;
-        variableRangeE = variableRangeS + 18;
-    }
-    //=== OVERFLOW END ==============================
-
     display.fillScreen(b);
     display.setTextColor(t);
-    display.setTextSize(3);
     display.setTextDatum(MC_DATUM);
-    String cityName = model.getCityName();
-    cityName.remove(cityName.indexOf(",", 0));
-    display.drawString(cityName, centre, 80, 2);
+    FixedString<WEATHER_CITY_LENGTH> cityName(model.getCityName().view().before(','));
+    char buffer[WEATHER_TEXT_BUFFER];
+    const char *lines[WEATHER_TEXT_LINES];
+    TextLayout cityLayout(display, 2, 3);
+    if (cityLayout.wrap(cityName.c_str(), 80, 0, buffer, sizeof(buffer), lines, 1) > 0) {
+        display.setTextSize(3);
+        display.drawString(lines[0], centre, 80, 2);
+    }
+    TextLayout textLayout(display, 1, 2);
+    int lineCount = textLayout.wrap(model.getCurrentText().c_str(), 120, 20, buffer, sizeof(buffer), lines, WEATHER_TEXT_LINES);
     display.setTextSize(2);
-    display.setTextFont(1);
-    display.drawString(messageArr[0], centre, 120);
-    display.drawString(messageArr[1], centre, 140);
-    display.drawString(messageArr[2], centre, 160);
-    display.drawString(messageArr[3], centre, 180);
+    for (int i = 0; i < lineCount; i++) {
+        display.drawString(lines[i], centre, 120 + 20 * i, 1);
+    }
 }
 
 // This displays the next 3 days weather forecast
@@ -266,33 +291,35 @@ void WeatherWidget::threeDayWeather(int displayIndex) {
 
     for (int i = 0; i < 3; i++) {
         int xOffset = (centre - 75) + i * 75;
-        String temperature;
+        FormattedFloat temperature;
         display.setTextColor(TFT_WHITE);
         if (m_mode == MODE_HIGHS) {
             temperature = model.getDayHigh(i, 0);
-            if (temperature != "") {
+            if (!temperature.isEmpty()) {
                 display.drawString("Highs", centre, 215, 1);
             }
         } else if (m_mode == MODE_LOWS) {
             temperature = model.getDayLow(i, 0);
-            if (temperature != "") {
+            if (!temperature.isEmpty()) {
                 display.drawString("Lows", centre, 215, 1);
             }
         }
-        drawWeatherIcon(model.getDayIcon(i), displayIndex, xOffset - 30, 47, 4);
+        drawWeatherIcon(model.getDayIcon(i).c_str(), displayIndex, xOffset - 30, 47, 4);
         display.setTextColor(TFT_BLACK);
-        if (temperature != "") {
-            drawDegrees(temperature, xOffset, centre, 2, 2, 4, 2, TFT_BLACK, TFT_WHITE);
+        if (!temperature.isEmpty()) {
+            drawDegrees(temperature.c_str(), xOffset, centre, 2, 2, 4, 2, TFT_BLACK, TFT_WHITE);
         }
 
-        String weekUpdate = dayStr(weekday(m_time->getUnixEpoch() + (86400 * (i + 1))));
-        weekUpdate.remove(3);
-        weekUpdate.toUpperCase();
+        char weekUpdate[4];
+        strlcpy(weekUpdate, dayStr(weekday(m_time->getUnixEpoch() + (86400 * (i + 1)))), sizeof(weekUpdate));
+        for (char &c : weekUpdate) {
+            c = toupper(c);
+        }
         display.drawString(weekUpdate, xOffset, 150, 2);
     }
 }
 
-int WeatherWidget::drawDegrees(String number, int x, int y, uint8_t font, uint8_t size, uint8_t outerRadius, uint8_t innerRadius, int16_t textColor, int16_t backgroundColor) {
+int WeatherWidget::drawDegrees(const char *number, int x, int y, uint8_t font, uint8_t size, uint8_t outerRadius, uint8_t innerRadius, int16_t textColor, int16_t backgroundColor) {
     TFT_eSPI &display = m_manager.getDisplay();
 
     display.setTextColor(textColor);
@@ -1,16 +1,58 @@
 
 #include "widgets/webDataWidget.h"
 
+#include <fetchPolicy.h>
+#include <heapAccounting.h>
+#include <imageCache.h>
+
+#include <new>
+
 WebDataWidget::WebDataWidget(ScreenManager &manager, String url) : Widget(manager) {
+    // sse:// and sses:// select push mode, the plain http(s) equivalent is polled as the fallback
+    if (isStreamUrl(url)) {
+        url = normalizeStreamUrl(url);
+        m_streamAddress = url;
+    }
+    // the server can hand out a stream later, so register either way
+    MemoryGovernor::getInstance()->add(this, "WebData stream", WEB_DATA_STREAM_MEMORY_PRIORITY);
     httpRequestAddress = url;
-
-    m_lastUpdate = 0;
-    for (int i = 0; i < 5; i++) {
-        m_obj[i] = WebDataModel();
+    for (WebDataModel &model : m_obj) {
+        model.setPool(&m_pool);
     }
+    // widgets showing the same URL share its fetches
+    DataSourceRegistry::getInstance()->subscribe(httpRequestAddress, this, m_updateDelay);
 }
 
 WebDataWidget::~WebDataWidget() {
+    DataSourceRegistry::getInstance()->unsubscribe(httpRequestAddress, this);
+    MemoryGovernor::getInstance()->remove(this);
+    closeStream();
+}
+
+// Drops the connection and its buffers, updates come from polling until the
+// stream is reopened. That waits a stream timeout so the heap can recover.
+bool WebDataWidget::releaseMemory() {
+    if (m_stream == nullptr || m_dispatching) {
+        return false;
+    }
+    closeStream();
+    m_streamRetryAt = millis() + WEB_DATA_STREAM_TIMEOUT;
+    return true;
+}
+
+bool WebDataWidget::isStreamUrl(const String &url) {
+    return url.startsWith("sse://") || url.startsWith("sses://");
+}
+
+// sse://host/path becomes http://host/path and sses:// becomes https://, anything else is kept
+String WebDataWidget::normalizeStreamUrl(const String &url) {
+    if (url.startsWith("sse://")) {
+        return "http://" + url.substring(6);
+    }
+    if (url.startsWith("sses://")) {
+        return "https://" + url.substring(7);
+    }
+    return url;
 }
 
 void WebDataWidget::setup() {
@@ -35,37 +77,277 @@ void WebDataWidget::draw(bool force) {
 }
 
 void WebDataWidget::update(bool force) {
-    if (force || m_lastUpdate == 0 || (millis() - m_lastUpdate) >= m_updateDelay) {
-        HTTPClient http;
-        http.begin(httpRequestAddress);
-        int httpCode = http.GET();
-
-        if (httpCode > 0) {  // Check for the returning code
-            JsonDocument doc;
-            DeserializationError error = deserializeJson(doc, http.getString());
-            if (!error) {
-                if (doc["interval"].is<int>()) {
-                    m_updateDelay = doc["interval"];
-                }
-                JsonVariant array;
-                if (doc["displays"].is<JsonArray>()) {
-                    array = doc["displays"].as<JsonArray>();
-                } else {
-                    // handle legacy response that doesn't have response level data
-                    array = doc.as<JsonArray>();
-                }
-                for (int i = 0; i < array.size(); i++) {
-                    m_obj[i].parseData(array[i].as<JsonObject>(), m_defaultColor, m_defaultBackground);
+    uint32_t imageGeneration = ImageCache::getInstance()->getGeneration();
+    if (imageGeneration != m_imageGeneration) {
+        // images arrive in the background after the element was parsed
+        m_imageGeneration = imageGeneration;
+        for (WebDataModel &model : m_obj) {
+            model.refreshImages();
+        }
+    }
+    if (millis() - m_lastHeapReport >= WEB_DATA_HEAP_REPORT_INTERVAL) {
+        m_lastHeapReport = millis();
+        Utils::printHeapStats("WebData");
+        m_pool.printStats("WebData");
+        DataSourceRegistry::getInstance()->printStatus();
+        if (m_streamArena != nullptr) {
+            m_streamArena->printStats();
+        }
+        MemoryGovernor::getInstance()->printStatus();
+    }
+    if (m_streamAddress != "") {
+        if (m_stream != nullptr) {
+            readStream();
+        } else if ((long)(millis() - m_streamRetryAt) >= 0) {
+            openStream();
+        }
+        if (m_stream != nullptr && !force) {
+            // pushed updates are applied as they arrive, no need to poll
+            return;
+        }
+    }
+    DataSourceRegistry::getInstance()->update(httpRequestAddress, force);
+}
+
+void WebDataWidget::onData(const String &url, JsonDocument &doc) {
+    applyDocument(doc);
+}
+
+void WebDataWidget::prepareRequest(HTTPClient &http, bool full) {
+    // servers that know MessagePack can send the denser encoding, everyone else keeps sending JSON
+    http.addHeader("Accept", "application/msgpack, application/json;q=0.9");
+    // 0 asks for the full state, anything else for the deltas since then
+    http.addHeader("X-WebData-Seq", String(full ? 0 : m_seq));
+}
+
+// Applies a polled or pushed document. This is either a full document with
+// response level data, a legacy array of displays, a single display that
+// carries its index in a "display" field or a list of element "deltas".
+// Deltas must continue the "seq" of the last applied document, otherwise we
+// drop them and ask for the full state again.
+void WebDataWidget::applyDocument(JsonDocument &doc) {
+    if (doc["interval"].is<int>()) {
+        m_updateDelay = doc["interval"];
+        DataSourceRegistry::getInstance()->setInterval(httpRequestAddress, this, m_updateDelay);
+    }
+    if (const char *stream = doc["stream"]) {
+        String address = normalizeStreamUrl(stream);
+        if (m_streamAddress != address) {
+            closeStream(true);
+            m_streamAddress = address;
+        }
+    }
+    if (doc["display"].is<int>()) {
+        int index = doc["display"];
+        if (index >= 0 && index < 5) {
+            m_obj[index].parseData(doc.as<JsonObject>(), m_defaultColor, m_defaultBackground);
+            markDataReceived();
+        }
+        return;
+    }
+    if (doc["deltas"].is<JsonArray>()) {
+        uint32_t seq = doc["seq"] | 0;
+        if (m_seq == 0 || seq != m_seq + 1) {
+            Serial.printf("WebData delta seq %u after %u, resyncing\n", seq, m_seq);
+            resync();
+            return;
+        }
+        for (JsonObject delta : doc["deltas"].as<JsonArray>()) {
+            int index = delta["display"] | 0;
+            if (index >= 0 && index < 5) {
+                m_obj[index].applyDelta(delta, m_defaultColor, m_defaultBackground);
+            }
+        }
+        m_seq = seq;
+        markDataReceived();
+        return;
+    }
+    m_seq = doc["seq"] | 0;
+    JsonVariant array;
+    if (doc["displays"].is<JsonArray>()) {
+        array = doc["displays"].as<JsonArray>();
+    } else {
+        // handle legacy response that doesn't have response level data
+        array = doc.as<JsonArray>();
+    }
+    for (int i = 0; i < array.size() && i < 5; i++) {
+        m_obj[i].parseData(array[i].as<JsonObject>(), m_defaultColor, m_defaultBackground);
+    }
+    if (array.size() > 0) {
+        markDataReceived();
+    }
+}
+
+// Forgets the delta sequence so the next poll or stream connect returns the full state
+void WebDataWidget::resync() {
+    m_seq = 0;
+    DataSourceRegistry::getInstance()->refresh(httpRequestAddress, true);
+    if (m_stream != nullptr) {
+        m_lastEventId = "";
+        closeStream(true);
+    }
+}
+
+bool WebDataWidget::openStream() {
+    if (!FetchPolicy::getInstance()->allowRequest(m_streamAddress)) {
+        return false;
+    }
+    // polling widgets never carry the arena, it comes and goes with the connection
+    MemoryGovernor::getInstance()->reserve(WEB_DATA_STREAM_ARENA, "WebData stream");
+    m_streamArena = new (std::nothrow) StaticJsonArena<WEB_DATA_STREAM_ARENA>("WebData stream");
+    if (m_streamArena == nullptr) {
+        Serial.println("WebData stream: no memory for its arena, polling instead");
+        m_streamRetryAt = millis() + WEB_DATA_STREAM_TIMEOUT;
+        return false;
+    }
+    m_streamHttp.begin(m_streamAddress);
+    // HTTP/1.0 keeps the body free of chunk framing so events can be read straight off the socket
+    m_streamHttp.useHTTP10(true);
+    m_streamHttp.addHeader("Accept", "text/event-stream");
+    m_streamHttp.addHeader("Cache-Control", "no-cache");
+    m_streamHttp.addHeader("X-WebData-Seq", String(m_seq));
+    if (m_lastEventId != "") {
+        // lets the server resume from the last event we applied
+        m_streamHttp.addHeader("Last-Event-ID", m_lastEventId);
+    }
+    int httpCode = m_streamHttp.GET();
+    FetchPolicy::getInstance()->reportResult(m_streamAddress, httpCode);
+    if (httpCode != HTTP_CODE_OK) {
+        Serial.printf("WebData stream failed, error: %s\n", m_streamHttp.errorToString(httpCode).c_str());
+        m_streamHttp.end();
+        delete m_streamArena;
+        m_streamArena = nullptr;
+        m_streamRetryAt = millis() + m_streamRetryDelay;
+        return false;
+    }
+    m_stream = m_streamHttp.getStreamPtr();
+    m_streamLine = "";
+    m_streamData = "";
+    m_streamLastActivity = millis();
+    Serial.println("WebData stream connected: " + m_streamAddress);
+    return true;
+}
+
+// Closing frees the arena, a document parsed into it may still be in use. A
+// close asked for while a pushed event is applied waits for dispatchStreamEvent().
+void WebDataWidget::closeStream(bool reconnectNow) {
+    if (m_stream == nullptr) {
+        return;
+    }
+    if (m_dispatching) {
+        m_closeRequested = true;
+        m_reconnectNow = m_reconnectNow || reconnectNow;
+        return;
+    }
+    m_streamHttp.end();
+    m_stream = nullptr;
+    delete m_streamArena;
+    m_streamArena = nullptr;
+    m_streamLine = "";
+    m_streamData = "";
+    m_streamRetryAt = reconnectNow ? millis() : millis() + m_streamRetryDelay;
+    Serial.println("WebData stream closed, polling until it reconnects");
+}
+
+// Reads whatever the stream has buffered without blocking the loop
+void WebDataWidget::readStream() {
+    char buf[128];
+    while (m_stream != nullptr && m_stream->available() > 0) {
+        int len = m_stream->read((uint8_t *)buf, sizeof(buf));
+        if (len <= 0) {
+            break;
+        }
+        m_streamLastActivity = millis();
+        int start = 0;
+        for (int i = 0; i < len; i++) {
+            if (buf[i] == '\n') {
+                m_streamLine.concat(buf + start, i - start);
+                processStreamLine(m_streamLine);
+                m_streamLine = "";
+                start = i + 1;
+                if (m_stream == nullptr) {
+                    // the event asked for a resync, the rest of the buffer is stale
+                    return;
                 }
-                m_lastUpdate = millis();
-            } else {
-                // Handle JSON deserialization error
-                Serial.println("deserializeJson() failed");
             }
+        }
+        m_streamLine.concat(buf + start, len - start);
+        if (m_streamLine.length() + m_streamData.length() > WEB_DATA_STREAM_MAX_EVENT) {
+            Serial.println("WebData stream event too large, dropping it");
+            m_streamLine = "";
+            m_streamData = "";
+        }
+    }
+    if (m_stream == nullptr) {
+        return;
+    }
+    if (!m_stream->connected() && m_stream->available() == 0) {
+        closeStream();
+    } else if (millis() - m_streamLastActivity > WEB_DATA_STREAM_TIMEOUT) {
+        Serial.println("WebData stream timed out");
+        closeStream();
+    }
+}
+
+void WebDataWidget::processStreamLine(String &line) {
+    if (line.endsWith("\r")) {
+        line.remove(line.length() - 1);
+    }
+    if (line.length() == 0) {
+        // a blank line terminates the event
+        dispatchStreamEvent();
+        return;
+    }
+    if (line[0] == ':') {
+        // comment, servers send these as keep-alives
+        return;
+    }
+    int colon = line.indexOf(':');
+    String field = colon == -1 ? line : line.substring(0, colon);
+    int valueStart = colon == -1 ? line.length() : colon + 1;
+    if (valueStart < line.length() && line[valueStart] == ' ') {
+        valueStart++;
+    }
+    if (field == "data") {
+        if (m_streamData.length() > 0) {
+            m_streamData += "\n";
+        }
+        m_streamData.concat(line.c_str() + valueStart, line.length() - valueStart);
+    } else if (field == "id") {
+        m_lastEventId = line.substring(valueStart);
+    } else if (field == "retry") {
+        long retry = line.substring(valueStart).toInt();
+        if (retry > 0) {
+            m_streamRetryDelay = retry;
+        }
+    }
+}
+
+void WebDataWidget::dispatchStreamEvent() {
+    if (m_streamData.length() == 0) {
+        return;
+    }
+    m_dispatching = true;
+    {
+        JsonDocument doc(m_streamArena);
+        DeserializationError error;
+        {
+            HeapTagGuard jsonTag("json");
+            error = deserializeJson(doc, m_streamData);
+        }
+        if (!error) {
+            applyDocument(doc);
         } else {
-            // Handle HTTP request error
-            Serial.printf("HTTP request failed, error: %s\n", http.errorToString(httpCode).c_str());
+            Serial.printf("deserializeJson() failed on pushed event: %s\n", error.c_str());
+            m_streamArena->printStats();
         }
-        http.end();
+    }
+    m_dispatching = false;
+    m_streamData = "";
+    if (m_closeRequested) {
+        // doc is gone, the arena can go with the connection
+        m_closeRequested = false;
+        closeStream(m_reconnectNow);
+        m_reconnectNow = false;
     }
 }
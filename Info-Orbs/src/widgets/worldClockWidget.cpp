@@ -0,0 +1,191 @@
+#include "widgets/worldClockWidget.h"
+
+#include <config.h>
+#include <textLayout.h>
+#include <timeZones.h>
+
+// cities is "Name|Zone,Name|Zone", the zone is an IANA name from timeZones.h or a POSIX TZ rule
+WorldClockWidget::WorldClockWidget(ScreenManager &manager, const char *cities) : Widget(manager) {
+    char list[strlen(cities) + 1];
+    strcpy(list, cities);
+
+    char *save;
+    for (char *entry = strtok_r(list, ",", &save); entry != nullptr; entry = strtok_r(nullptr, ",", &save)) {
+        char *zone = strchr(entry, '|');
+        if (zone == nullptr) {
+            Serial.printf("World clock: no zone for %s\n", entry);
+            continue;
+        }
+        *zone++ = '\0';
+        if (m_cityCount == WORLD_CLOCK_MAX_CITIES) {
+            Serial.println("MAX WORLD CLOCK CITIES UNABLE TO ADD MORE");
+            break;
+        }
+        addCity(entry, zone);
+    }
+    MemoryGovernor::getInstance()->add(this, "world clock glyphs", WORLD_CLOCK_MEMORY_PRIORITY);
+}
+
+WorldClockWidget::~WorldClockWidget() {
+    MemoryGovernor::getInstance()->remove(this);
+    releaseMemory();
+}
+
+// The next drawCity renders the glyphs again
+bool WorldClockWidget::releaseMemory() {
+    if (m_glyphs[0] == nullptr) {
+        return false;
+    }
+    for (TFT_eSprite *&glyph : m_glyphs) {
+        if (glyph != nullptr) {
+            glyph->deleteSprite();
+            delete glyph;
+            glyph = nullptr;
+        }
+    }
+    return true;
+}
+
+bool WorldClockWidget::addCity(const char *name, const char *zone) {
+    City &city = m_cities[m_cityCount];
+    const char *rule = findTimeZone(zone);
+    if (!city.zone.parse(rule != nullptr ? rule : zone)) {
+        Serial.printf("World clock: unknown zone %s for %s\n", zone, name);
+        return false;
+    }
+    strlcpy(city.name, name, sizeof(city.name));
+    city.minute = -1;
+    city.time[0] = '\0';
+    city.day[0] = '\0';
+    city.changed = true;
+    m_cityCount++;
+    return true;
+}
+
+void WorldClockWidget::setup() {
+    for (int i = 0; i < m_cityCount; i++) {
+        m_cities[i].minute = -1;
+    }
+}
+
+// Works out each city's local time, cities whose minute didn't move are left alone
+void WorldClockWidget::update(bool force) {
+    GlobalTime *time = GlobalTime::getInstance();
+    time_t utc = time->getUtcEpoch();
+    if (time->isSynced()) {
+        markDataReceived();
+    }
+    for (int i = 0; i < m_cityCount; i++) {
+        City &city = m_cities[i];
+        time_t local = city.zone.toLocal(utc);
+        if (local / 60 == city.minute && !force) {
+            continue;
+        }
+        city.minute = local / 60;
+        tmElements_t elements;
+        breakTime(local, elements);
+        int hour = elements.Hour;
+        if (!time->getFormat24Hour()) {
+            hour = hour % 12 == 0 ? 12 : hour % 12;
+        }
+        snprintf(city.nextTime, sizeof(city.nextTime), "%d:%02d", hour, elements.Minute);
+        if (time->getFormat24Hour()) {
+            snprintf(city.nextDay, sizeof(city.nextDay), "%s %d", dayShortStr(elements.Wday), elements.Day);
+        } else {
+            snprintf(city.nextDay, sizeof(city.nextDay), "%s %d %s", dayShortStr(elements.Wday), elements.Day, elements.Hour >= 12 ? "PM" : "AM");
+        }
+        city.changed = true;
+    }
+}
+
+void WorldClockWidget::draw(bool force) {
+    for (int i = 0; i < m_cityCount; i++) {
+        if (m_cities[i].changed || force) {
+            drawCity(i, force);
+        }
+    }
+}
+
+void WorldClockWidget::changeMode() {
+    GlobalTime *time = GlobalTime::getInstance();
+    time->setFormat24Hour(!time->getFormat24Hour());
+    update(true);
+    draw(true);
+}
+
+void WorldClockWidget::drawCity(int index, bool force) {
+    City &city = m_cities[index];
+    m_manager.selectScreen(index);
+    TFT_eSPI &display = m_manager.getDisplay();
+    if (m_glyphs[0] == nullptr) {
+        createGlyphs(display);
+    }
+    // nothing of this city is on screen yet
+    force = force || city.time[0] == '\0';
+    if (force) {
+        display.fillScreen(TFT_BLACK);
+        display.setTextDatum(MC_DATUM);
+        display.setTextColor(FOREGROUND_COLOR, TFT_BLACK);
+        char buffer[WORLD_CLOCK_NAME_LENGTH + 4];
+        const char *lines[1];
+        TextLayout layout(display, 2, 2);
+        if (layout.wrap(city.name, 65, 0, buffer, sizeof(buffer), lines, 1) > 0) {
+            display.setTextSize(2);
+            display.drawString(lines[0], SCREEN_SIZE / 2, 65, 2);
+        }
+    }
+    drawTime(display, city, force);
+    if (force || strcmp(city.day, city.nextDay) != 0) {
+        display.setTextDatum(MC_DATUM);
+        display.setTextSize(2);
+        display.setTextColor(TFT_WHITE, TFT_BLACK);
+        display.fillRect(40, 160, SCREEN_SIZE - 80, 24, TFT_BLACK);
+        display.drawString(city.nextDay, SCREEN_SIZE / 2, 172, 2);
+        strlcpy(city.day, city.nextDay, sizeof(city.day));
+    }
+    city.changed = false;
+}
+
+// Pushes only the glyphs that differ from what is on screen. When the width
+// changes (9:59 to 10:00) the digits move, so the whole band is redrawn.
+void WorldClockWidget::drawTime(TFT_eSPI &display, City &city, bool force) {
+    bool moved = force || strlen(city.time) != strlen(city.nextTime);
+    if (moved) {
+        display.fillRect(0, WORLD_CLOCK_TIME_Y, SCREEN_SIZE, m_glyphHeight, TFT_BLACK);
+    }
+    int x = (SCREEN_SIZE - glyphWidth(city.nextTime)) / 2;
+    for (int i = 0; city.nextTime[i] != '\0'; i++) {
+        int glyph = strchr(WORLD_CLOCK_GLYPHS, city.nextTime[i]) - WORLD_CLOCK_GLYPHS;
+        if (moved || city.time[i] != city.nextTime[i]) {
+            m_glyphs[glyph]->pushSprite(x, WORLD_CLOCK_TIME_Y);
+        }
+        x += m_glyphWidths[glyph];
+    }
+    strlcpy(city.time, city.nextTime, sizeof(city.time));
+}
+
+int WorldClockWidget::glyphWidth(const char *text) {
+    int width = 0;
+    for (; *text != '\0'; text++) {
+        width += m_glyphWidths[strchr(WORLD_CLOCK_GLYPHS, *text) - WORLD_CLOCK_GLYPHS];
+    }
+    return width;
+}
+
+// Renders every glyph once into a 1 bit sprite, a few hundred bytes each
+void WorldClockWidget::createGlyphs(TFT_eSPI &display) {
+    display.setTextSize(1);
+    m_glyphHeight = display.fontHeight(WORLD_CLOCK_FONT);
+    for (int i = 0; WORLD_CLOCK_GLYPHS[i] != '\0'; i++) {
+        char text[2] = {WORLD_CLOCK_GLYPHS[i], '\0'};
+        m_glyphWidths[i] = display.textWidth(text, WORLD_CLOCK_FONT);
+        m_glyphs[i] = new TFT_eSprite(&display);
+        m_glyphs[i]->setColorDepth(1);
+        m_glyphs[i]->createSprite(m_glyphWidths[i], m_glyphHeight);
+        m_glyphs[i]->fillSprite(TFT_BLACK);
+        m_glyphs[i]->setTextColor(TFT_WHITE, TFT_BLACK);
+        m_glyphs[i]->setTextDatum(TL_DATUM);
+        m_glyphs[i]->drawString(text, 0, 0, WORLD_CLOCK_FONT);
+        m_glyphs[i]->setBitmapColor(TFT_WHITE, TFT_BLACK);
+    }
+}
@@ -0,0 +1,152 @@
+#include <TFT_eSPI.h>
+#include <colorNames.h>
+#include <lookupTable.h>
+#include <unity.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+// Looks up color names through the perfect hash table Utils::stringToColor
+// uses, from colorNames.h, and through the if/else chain it replaced, which
+// lowercased and stripped a String copy before comparing. The chain is kept
+// here as the reference the table has to agree with.
+#define ITERATIONS 20000
+
+#define COLOR_COUNT (sizeof(COLOR_NAME_ENTRIES) / sizeof(COLOR_NAME_ENTRIES[0]))
+#define MISS -1
+
+// What arrives from WebData responses: exact, mixed case, spaced and unknown names
+static const char *queries[] = {
+    "white", "black", "red", "Dark Green", "SkyBlue", "light grey", "vilolet", "YELLOW",
+    "#ff0000", "0xF800", "chartreuse", "", "transparent", "gold", "Green Yellow", "silver",
+};
+#define QUERY_COUNT (sizeof(queries) / sizeof(queries[0]))
+
+__attribute__((noinline)) static int32_t chainLookup(const char *name) {
+    std::string color = name;
+    std::transform(color.begin(), color.end(), color.begin(), [](char c) { return lookup::lower(c); });
+    color.erase(std::remove(color.begin(), color.end(), ' '), color.end());
+    if (color == "black") {
+        return TFT_BLACK;
+    } else if (color == "navy") {
+        return TFT_NAVY;
+    } else if (color == "darkgreen") {
+        return TFT_DARKGREEN;
+    } else if (color == "darkcyan") {
+        return TFT_DARKCYAN;
+    } else if (color == "maroon") {
+        return TFT_MAROON;
+    } else if (color == "purple") {
+        return TFT_PURPLE;
+    } else if (color == "olive") {
+        return TFT_OLIVE;
+    } else if (color == "lightgrey" || color == "grey") {
+        return TFT_LIGHTGREY;
+    } else if (color == "darkgrey") {
+        return TFT_DARKGREY;
+    } else if (color == "blue") {
+        return TFT_BLUE;
+    } else if (color == "green") {
+        return TFT_GREEN;
+    } else if (color == "cyan") {
+        return TFT_CYAN;
+    } else if (color == "red") {
+        return TFT_RED;
+    } else if (color == "magenta") {
+        return TFT_MAGENTA;
+    } else if (color == "yellow") {
+        return TFT_YELLOW;
+    } else if (color == "white") {
+        return TFT_WHITE;
+    } else if (color == "orange") {
+        return TFT_ORANGE;
+    } else if (color == "greenyellow") {
+        return TFT_GREENYELLOW;
+    } else if (color == "pink") {
+        return TFT_PINK;
+    } else if (color == "brown") {
+        return TFT_BROWN;
+    } else if (color == "gold") {
+        return TFT_GOLD;
+    } else if (color == "silver") {
+        return TFT_SILVER;
+    } else if (color == "skyblue") {
+        return TFT_SKYBLUE;
+    } else if (color == "violet" || color == "vilolet") {
+        return TFT_VIOLET;
+    }
+    return MISS;
+}
+
+__attribute__((noinline)) static int32_t tableLookup(const char *name) {
+    return COLOR_NAMES.get(name, MISS);
+}
+
+template <typename Lookup>
+static double nanosPerLookup(Lookup lookup, int64_t &checksum) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        for (const char *query : queries) {
+            checksum += lookup(query);
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ITERATIONS / QUERY_COUNT;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_every_key_is_found() {
+    for (const LookupEntry<int32_t> &entry : COLOR_NAME_ENTRIES) {
+        int32_t value = MISS;
+        TEST_ASSERT_TRUE_MESSAGE(COLOR_NAMES.find(entry.key, value), entry.key);
+        TEST_ASSERT_EQUAL_INT32(entry.value, value);
+    }
+}
+
+void test_case_and_spaces_are_ignored() {
+    TEST_ASSERT_EQUAL_INT32(TFT_DARKGREEN, COLOR_NAMES.get("Dark Green", MISS));
+    TEST_ASSERT_EQUAL_INT32(TFT_SKYBLUE, COLOR_NAMES.get(" SKY blue ", MISS));
+    TEST_ASSERT_EQUAL_INT32(TFT_LIGHTGREY, COLOR_NAMES.get("LightGrey", MISS));
+}
+
+void test_misses_return_the_fallback() {
+    TEST_ASSERT_EQUAL_INT32(MISS, COLOR_NAMES.get("chartreuse", MISS));
+    TEST_ASSERT_EQUAL_INT32(MISS, COLOR_NAMES.get("", MISS));
+    TEST_ASSERT_EQUAL_INT32(MISS, COLOR_NAMES.get("redd", MISS));
+    TEST_ASSERT_EQUAL_INT32(MISS, COLOR_NAMES.get("#ff0000", MISS));
+}
+
+void test_table_matches_the_chain() {
+    for (const char *query : queries) {
+        TEST_ASSERT_EQUAL_INT32_MESSAGE(chainLookup(query), tableLookup(query), query);
+    }
+}
+
+void test_lookup_cost() {
+    int64_t tableChecksum = 0;
+    int64_t chainChecksum = 0;
+    double tableNanos = nanosPerLookup(tableLookup, tableChecksum);
+    double chainNanos = nanosPerLookup(chainLookup, chainChecksum);
+    char report[160];
+    snprintf(report, sizeof(report), "%u keys, %u queries: table %.2f ns, if/else chain %.2f ns per lookup",
+             (unsigned)COLOR_COUNT, (unsigned)QUERY_COUNT, tableNanos, chainNanos);
+    TEST_MESSAGE(report);
+    // timings depend on the host, only the results are asserted
+    TEST_ASSERT_TRUE(tableChecksum == chainChecksum);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_every_key_is_found);
+    RUN_TEST(test_case_and_spaces_are_ignored);
+    RUN_TEST(test_misses_return_the_fallback);
+    RUN_TEST(test_table_matches_the_chain);
+    RUN_TEST(test_lookup_cost);
+    return UNITY_END();
+}
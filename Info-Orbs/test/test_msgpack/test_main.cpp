@@ -0,0 +1,161 @@
+#include <ArduinoJson.h>
+#include <model/webDataElement.h>
+#include <unity.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#include <chrono>
+#include <string>
+
+// A dense dashboard: five displays with rectangles, lines, arcs and text.
+// The JSON fixture uses type and color names, the MessagePack one the
+// compact integer encodings a server negotiating msgpack sends. Both must
+// decode to the same elements.
+#define DISPLAYS 5
+#define ELEMENTS_PER_DISPLAY 40
+#define ITERATIONS 2000
+
+static const char *TYPE_NAMES[] = {"rectangle", "line", "arc", "text"};
+static const WebDataElementModelTypes TYPE_CODES[] = {RECTANGLE, LINE, ARC, TEXT};
+static const char *COLOR_NAMES[] = {"red", "green", "blue", "yellow"};
+static const int32_t COLOR_CODES[] = {TFT_RED, TFT_GREEN, TFT_BLUE, TFT_YELLOW};
+
+static std::string jsonFixture;
+static std::string msgPackFixture;
+
+static void buildFixtures() {
+    JsonDocument named;
+    JsonDocument compact;
+    named["seq"] = 1;
+    compact["seq"] = 1;
+    JsonArray namedDisplays = named["displays"].to<JsonArray>();
+    JsonArray compactDisplays = compact["displays"].to<JsonArray>();
+    for (int d = 0; d < DISPLAYS; d++) {
+        JsonObject namedDisplay = namedDisplays.add<JsonObject>();
+        JsonObject compactDisplay = compactDisplays.add<JsonObject>();
+        namedDisplay["label"] = "Load";
+        compactDisplay["label"] = "Load";
+        JsonArray namedData = namedDisplay["data"].to<JsonArray>();
+        JsonArray compactData = compactDisplay["data"].to<JsonArray>();
+        for (int e = 0; e < ELEMENTS_PER_DISPLAY; e++) {
+            int kind = e % 4;
+            JsonObject n = namedData.add<JsonObject>();
+            JsonObject c = compactData.add<JsonObject>();
+            n["type"] = TYPE_NAMES[kind];
+            c["type"] = (int)TYPE_CODES[kind];
+            n["color"] = COLOR_NAMES[e % 4];
+            c["color"] = COLOR_CODES[e % 4];
+            for (JsonObject element : {n, c}) {
+                element["x"] = 20 + e * 4;
+                element["y"] = 30 + d * 10 + e;
+                if (kind == 0) {
+                    element["width"] = 40;
+                    element["height"] = 50 + e;
+                } else if (kind == 2) {
+                    element["radius"] = 100;
+                    element["innerRadius"] = 90;
+                    element["angleStart"] = 0;
+                    element["angleEnd"] = e * 9;
+                } else if (kind == 3) {
+                    element["text"] = "42.5%";
+                    element["font"] = 2;
+                    element["size"] = 1;
+                } else {
+                    element["x2"] = 60 + e * 4;
+                    element["y2"] = 80 + e;
+                }
+            }
+        }
+    }
+    serializeJson(named, jsonFixture);
+    serializeMsgPack(compact, msgPackFixture);
+}
+
+template <typename Parse>
+static double microsPerParse(Parse parse) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; i++) {
+        parse();
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / ITERATIONS;
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+static int indexOf(const char *const *names, int count, const char *name) {
+    for (int i = 0; i < count; i++) {
+        if (name != nullptr && strcmp(names[i], name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static std::string asText(JsonVariantConst value) {
+    std::string text;
+    serializeJson(value, text);
+    return text;
+}
+
+// Every field of every element decodes to the same value, names are
+// compared by the code the server sends in their place
+void test_both_formats_decode_the_same_elements() {
+    JsonDocument json;
+    JsonDocument msgPack;
+    TEST_ASSERT_TRUE(deserializeJson(json, jsonFixture) == DeserializationError::Ok);
+    TEST_ASSERT_TRUE(deserializeMsgPack(msgPack, msgPackFixture) == DeserializationError::Ok);
+    TEST_ASSERT_EQUAL_INT(json["seq"].as<int>(), msgPack["seq"].as<int>());
+    for (int d = 0; d < DISPLAYS; d++) {
+        TEST_ASSERT_EQUAL_STRING(json["displays"][d]["label"].as<const char *>(), msgPack["displays"][d]["label"].as<const char *>());
+        JsonArray a = json["displays"][d]["data"];
+        JsonArray b = msgPack["displays"][d]["data"];
+        TEST_ASSERT_EQUAL_INT(ELEMENTS_PER_DISPLAY, a.size());
+        TEST_ASSERT_EQUAL_INT(ELEMENTS_PER_DISPLAY, b.size());
+        for (int e = 0; e < ELEMENTS_PER_DISPLAY; e++) {
+            JsonObject named = a[e];
+            JsonObject compact = b[e];
+            TEST_ASSERT_EQUAL_INT(named.size(), compact.size());
+            for (JsonPair field : named) {
+                const char *key = field.key().c_str();
+                TEST_ASSERT_FALSE_MESSAGE(compact[key].isNull(), key);
+                if (strcmp(key, "type") == 0) {
+                    int kind = indexOf(TYPE_NAMES, 4, field.value().as<const char *>());
+                    TEST_ASSERT_TRUE_MESSAGE(kind != -1, key);
+                    TEST_ASSERT_EQUAL_INT(TYPE_CODES[kind], compact[key].as<int>());
+                } else if (strcmp(key, "color") == 0) {
+                    int color = indexOf(COLOR_NAMES, 4, field.value().as<const char *>());
+                    TEST_ASSERT_TRUE_MESSAGE(color != -1, key);
+                    TEST_ASSERT_EQUAL_INT32(COLOR_CODES[color], compact[key].as<int32_t>());
+                } else {
+                    TEST_ASSERT_EQUAL_STRING_MESSAGE(asText(field.value()).c_str(), asText(compact[key]).c_str(), key);
+                }
+            }
+        }
+    }
+}
+
+void test_parse_cost() {
+    JsonDocument doc;
+    double jsonMicros = microsPerParse([&] { deserializeJson(doc, jsonFixture); });
+    double msgPackMicros = microsPerParse([&] { deserializeMsgPack(doc, msgPackFixture); });
+    char report[160];
+    snprintf(report, sizeof(report), "%d elements: json %u bytes %.1f us, msgpack %u bytes %.1f us per parse",
+             DISPLAYS * ELEMENTS_PER_DISPLAY, (unsigned)jsonFixture.size(), jsonMicros, (unsigned)msgPackFixture.size(), msgPackMicros);
+    TEST_MESSAGE(report);
+    // timings depend on the host, only the size is asserted
+    TEST_ASSERT_LESS_THAN(jsonFixture.size(), msgPackFixture.size());
+}
+
+int main(int argc, char **argv) {
+    buildFixtures();
+    UNITY_BEGIN();
+    RUN_TEST(test_both_formats_decode_the_same_elements);
+    RUN_TEST(test_parse_cost);
+    return UNITY_END();
+}
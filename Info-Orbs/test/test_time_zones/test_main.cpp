@@ -0,0 +1,150 @@
+#include <posixTimeZone.h>
+#include <timeZones.h>
+#include <unity.h>
+
+// lib/ isn't built for native tests, the evaluator has no Arduino dependencies
+#include <posixTimeZone.cpp>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include <vector>
+
+// Steps every zone of TIME_ZONES through the years the firmware will run in
+// and compares the UTC offset its POSIX rule gives with the host's zoneinfo
+// for the same location. The host C library stands in for newlib here, both
+// implement the same POSIX TZ rules.
+#define FIRST_YEAR 2025
+#define LAST_YEAR 2030
+#define LAST_EVALUATOR_YEAR 2040  // PosixTimeZone against the C library, covers the rules only
+#define STEP (30 * 60)  // transitions fall on the hour or half hour
+#define ZONEINFO "/usr/share/zoneinfo/"
+
+static int64_t daysFromCivil(int64_t year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    int64_t era = (year >= 0 ? year : year - 399) / 400;
+    unsigned yearOfEra = (unsigned)(year - era * 400);
+    unsigned dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    unsigned dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + (int64_t)dayOfEra - 719468;
+}
+
+static time_t utc(int year, int month, int day, int hour, int minute) {
+    return (time_t)(daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60);
+}
+
+static void setZone(const char *tz) {
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+// Seconds local time is ahead of UTC at t, without relying on tm_gmtoff
+static long offsetAt(time_t t) {
+    struct tm local;
+    localtime_r(&t, &local);
+    time_t asUtc = utc(local.tm_year + 1900, local.tm_mon + 1, local.tm_mday, local.tm_hour, local.tm_min) + local.tm_sec;
+    return (long)(asUtc - t);
+}
+
+static std::vector<long> offsets(const char *tz) {
+    setZone(tz);
+    std::vector<long> result;
+    for (time_t t = utc(FIRST_YEAR, 1, 1, 0, 0); t < utc(LAST_YEAR + 1, 1, 1, 0, 0); t += STEP) {
+        result.push_back(offsetAt(t));
+    }
+    return result;
+}
+
+static void assertOffsetChange(const char *tz, time_t transition, long before, long after) {
+    setZone(tz);
+    char message[96];
+    snprintf(message, sizeof(message), "%s before the transition", tz);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(before, offsetAt(transition - 1), message);
+    snprintf(message, sizeof(message), "%s at the transition", tz);
+    TEST_ASSERT_EQUAL_INT_MESSAGE(after, offsetAt(transition), message);
+}
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+    setZone("UTC0");
+}
+
+void test_lookup_finds_every_zone() {
+    for (const TimeZoneRule &zone : TIME_ZONES) {
+        TEST_ASSERT_TRUE_MESSAGE(findTimeZone(zone.location) == zone.posix, zone.location);
+    }
+    TEST_ASSERT_TRUE(findTimeZone("europe/berlin") != nullptr);
+    TEST_ASSERT_TRUE(findTimeZone("Mars/Olympus_Mons") == nullptr);
+}
+
+void test_known_transitions() {
+    assertOffsetChange(findTimeZone("Europe/Berlin"), utc(2025, 3, 30, 1, 0), 3600, 7200);
+    assertOffsetChange(findTimeZone("Europe/Berlin"), utc(2025, 10, 26, 1, 0), 7200, 3600);
+    assertOffsetChange(findTimeZone("America/New_York"), utc(2025, 3, 9, 7, 0), -18000, -14400);
+    assertOffsetChange(findTimeZone("America/New_York"), utc(2025, 11, 2, 6, 0), -14400, -18000);
+    assertOffsetChange(findTimeZone("Australia/Sydney"), utc(2025, 4, 5, 16, 0), 39600, 36000);
+    assertOffsetChange(findTimeZone("America/St_Johns"), utc(2025, 3, 9, 5, 30), -12600, -9000);
+}
+
+void test_rules_match_zoneinfo() {
+    int compared = 0;
+    for (const TimeZoneRule &zone : TIME_ZONES) {
+        char path[96];
+        snprintf(path, sizeof(path), ZONEINFO "%s", zone.location);
+        FILE *file = fopen(path, "rb");
+        if (file == nullptr) {
+            continue;
+        }
+        fclose(file);
+        char tz[96];
+        snprintf(tz, sizeof(tz), ":%s", zone.location);
+        std::vector<long> expected = offsets(tz);
+        std::vector<long> actual = offsets(zone.posix);
+        for (size_t i = 0; i < expected.size(); i++) {
+            if (expected[i] != actual[i]) {
+                time_t t = utc(FIRST_YEAR, 1, 1, 0, 0) + (time_t)i * STEP;
+                char message[160];
+                snprintf(message, sizeof(message), "%s (%s) at %lld", zone.location, zone.posix, (long long)t);
+                TEST_ASSERT_EQUAL_INT_MESSAGE(expected[i], actual[i], message);
+            }
+        }
+        compared++;
+    }
+    if (compared == 0) {
+        TEST_IGNORE_MESSAGE("no zoneinfo on this host");
+    }
+    char report[64];
+    snprintf(report, sizeof(report), "%d of %u zones compared with zoneinfo", compared, (unsigned)(sizeof(TIME_ZONES) / sizeof(TIME_ZONES[0])));
+    TEST_MESSAGE(report);
+}
+
+// PosixTimeZone evaluates the rules itself for the world clock, it has to
+// agree with what the C library makes of the same rule
+void test_evaluator_matches_the_c_library() {
+    for (const TimeZoneRule &zone : TIME_ZONES) {
+        PosixTimeZone evaluator;
+        TEST_ASSERT_TRUE_MESSAGE(evaluator.parse(zone.posix), zone.posix);
+        setZone(zone.posix);
+        for (time_t t = utc(FIRST_YEAR, 1, 1, 0, 0); t < utc(LAST_EVALUATOR_YEAR + 1, 1, 1, 0, 0); t += STEP) {
+            long expected = offsetAt(t);
+            long actual = evaluator.getOffset(t);
+            if (expected != actual) {
+                char message[160];
+                snprintf(message, sizeof(message), "%s (%s) at %lld", zone.location, zone.posix, (long long)t);
+                TEST_ASSERT_EQUAL_INT_MESSAGE(expected, actual, message);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_lookup_finds_every_zone);
+    RUN_TEST(test_known_transitions);
+    RUN_TEST(test_rules_match_zoneinfo);
+    RUN_TEST(test_evaluator_matches_the_c_library);
+    return UNITY_END();
+}
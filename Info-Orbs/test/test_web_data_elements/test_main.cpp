@@ -0,0 +1,85 @@
+#include <model/webDataElement.h>
+#include <unity.h>
+
+#include <stdio.h>
+
+#include <string>
+
+// Compares the flat WebDataElement record with the per-element heap objects
+// with virtual draw used before. Only memory is measured here, the draw
+// dispatch needs the display driver and is not timed on the host.
+#define ELEMENTS 500
+
+// The layout before flat records: int32_t fields, string members and one
+// heap object per element behind a pointer
+struct LegacyElement {
+    virtual ~LegacyElement() = default;
+    virtual void draw() = 0;
+    std::string id;
+    int32_t x = 0;
+    int32_t y = 0;
+    int32_t color = TFT_WHITE;
+    int32_t background = TFT_BLACK;
+};
+
+struct LegacyRectangle : LegacyElement {
+    int32_t width = 0;
+    int32_t height = 0;
+    bool filled = true;
+    void draw() override {}
+};
+
+struct LegacyLine : LegacyElement {
+    int32_t x2 = 0;
+    int32_t y2 = 0;
+    void draw() override {}
+};
+
+struct LegacyArc : LegacyElement {
+    int32_t radius = 0;
+    int32_t innerRadius = 0;
+    int32_t angleStart = 0;
+    int32_t angleEnd = 0;
+    void draw() override {}
+};
+
+struct LegacyText : LegacyElement {
+    std::string text;
+    int32_t font = 2;
+    int32_t size = 2;
+    int32_t datum = MC_DATUM;
+    void draw() override {}
+};
+
+void setUp(void) {
+}
+
+void tearDown(void) {
+}
+
+void test_record_stays_compact() {
+    TEST_ASSERT_LESS_OR_EQUAL(36, sizeof(WebDataElement));
+}
+
+void test_memory_per_element() {
+    // a dashboard of rectangles, lines, arcs and texts in equal parts
+    size_t legacyBytes = 0;
+    for (int i = 0; i < 4; i++) {
+        // pointer plus object as laid out on this host, heap block headers not counted
+        size_t object = i == 0 ? sizeof(LegacyRectangle) : i == 1 ? sizeof(LegacyLine) : i == 2 ? sizeof(LegacyArc) : sizeof(LegacyText);
+        legacyBytes += sizeof(LegacyElement *) + object;
+    }
+    legacyBytes /= 4;
+    char report[160];
+    snprintf(report, sizeof(report), "%d elements: flat %u bytes, polymorphic %u bytes",
+             ELEMENTS, (unsigned)(ELEMENTS * sizeof(WebDataElement)), (unsigned)(ELEMENTS * legacyBytes));
+    TEST_MESSAGE(report);
+    TEST_ASSERT_LESS_THAN(legacyBytes, sizeof(WebDataElement));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_record_stays_compact);
+    RUN_TEST(test_memory_per_element);
+    return UNITY_END();
+}